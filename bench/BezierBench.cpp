@@ -0,0 +1,320 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Suites.hpp"
+#include "warp/Bezier.hpp"
+#include "warp/CSplineSurface.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/Tessellation.hpp"
+
+namespace bench {
+
+namespace {
+
+// The distortion mesh generator as it was before the table based rewrite,
+// kept as the reference for speed and accuracy comparisons.
+namespace legacy {
+
+using KeyPoints = std::array<glm::vec2, 16>;
+
+gles2::CMesh::Vertices generateDistortionVertices(
+    std::size_t count,
+    const KeyPoints& kps)
+{
+  struct Math
+  {
+    static glm::vec2 bezier(
+        const glm::vec2& p0,
+        const glm::vec2& p1,
+        const glm::vec2& p2,
+        const glm::vec2& p3,
+        float u)
+    {
+      return std::pow(u, 3.f) * p3 + 3 * std::pow(u, 2.f) * (1.f - u) * p2 +
+             3 * u * std::pow(1.f - u, 2.f) * p1 + std::pow(1.f - u, 3.f) * p0;
+    }
+
+    static std::pair<std::vector<glm::vec2>, std::vector<glm::vec2>>
+    bezierControlPoints(std::vector<glm::vec2> knots)
+    {
+      // https://www.particleincell.com/2012/bezier-splines/
+      const int num = static_cast<int>(knots.size()) - 1;
+
+      std::vector<glm::vec2> p1(num);
+      std::vector<glm::vec2> p2(num);
+
+      /*rhs vector*/
+      std::vector<float> a(num);
+      std::vector<float> b(num);
+      std::vector<float> c(num);
+      std::vector<glm::vec2> r(num);
+
+      /*left most segment*/
+      a[0] = 0;
+      b[0] = 2;
+      c[0] = 1;
+      r[0] = knots[0] + knots[1] * 2.f;
+
+      /*internal segments*/
+      for (int i = 1; i < num - 1; i++)
+      {
+        a[i] = 1;
+        b[i] = 4;
+        c[i] = 1;
+        r[i] = knots[i] * 4.f + knots[i + 1] * 2.f;
+      }
+
+      /*right segment*/
+      a[num - 1] = 2;
+      b[num - 1] = 7;
+      c[num - 1] = 0;
+      r[num - 1] = knots[num - 1] * 8.f + knots[num];
+
+      /*solves Ax=b with the Thomas algorithm (from Wikipedia)*/
+      for (int i = 1; i < num; ++i)
+      {
+        float m = a[i] / b[i - 1];
+        b[i] = b[i] - c[i - 1] * m;
+        r[i] = r[i] - r[i - 1] * m;
+      }
+
+      p1[num - 1] = r[num - 1] / b[num - 1];
+      for (int i = num - 2; i >= 0; --i)
+      {
+        p1[i] = (r[i] - p1[i + 1] * c[i]) / b[i];
+      }
+
+      /*we have p1, now compute p2*/
+      for (int i = 0; i < num - 1; ++i)
+      {
+        p2[i] = knots[i + 1] * 2.f - p1[i + 1];
+      }
+
+      p2[num - 1] = (knots[num] + p1[num - 1]) * 0.5f;
+
+      return std::make_pair(p1, p2);
+    }
+  };
+
+  gles2::CMesh::Vertices dist_vertices;
+  const auto & [ p1y0, p2y0 ] =
+      Math::bezierControlPoints({kps[0], kps[4], kps[8], kps[12]});
+  const auto & [ p1y1, p2y1 ] =
+      Math::bezierControlPoints({kps[1], kps[5], kps[9], kps[13]});
+  const auto & [ p1y2, p2y2 ] =
+      Math::bezierControlPoints({kps[2], kps[6], kps[10], kps[14]});
+  const auto & [ p1y3, p2y3 ] =
+      Math::bezierControlPoints({kps[3], kps[7], kps[11], kps[15]});
+
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    for (std::size_t ii = 0; ii < count / 3; ++ii)
+    {
+      float px = static_cast<float>(ii) / (count / 3 - 1);
+      glm::vec2 p0y = Math::bezier(
+          kps[4 * i + 0], p1y0[i], p2y0[i], kps[4 * (i + 1) + 0], px);
+      glm::vec2 p1y = Math::bezier(
+          kps[4 * i + 1], p1y1[i], p2y1[i], kps[4 * (i + 1) + 1], px);
+      glm::vec2 p2y = Math::bezier(
+          kps[4 * i + 2], p1y2[i], p2y2[i], kps[4 * (i + 1) + 2], px);
+      glm::vec2 p3y = Math::bezier(
+          kps[4 * i + 3], p1y3[i], p2y3[i], kps[4 * (i + 1) + 3], px);
+
+      std::vector<glm::vec2> knots = {p0y, p1y, p2y, p3y};
+      const auto & [ p1x0, p2x0 ] = Math::bezierControlPoints(knots);
+
+      for (std::size_t j = 0; j < 3; ++j)
+      {
+        for (std::size_t jj = 0; jj < count / 3; ++jj)
+        {
+          float py = static_cast<float>(jj) / (count / 3 - 1);
+          glm::vec2 p =
+              Math::bezier(knots[j], p1x0[j], p2x0[j], knots[j + 1], py);
+
+          dist_vertices.push_back(
+              {glm::vec3(std::move(p), 0.f),
+               glm::vec2(i / 3.f + 1 / 3.f * px, j / 3.f + 1 / 3.f * py)});
+        }
+      }
+    }
+  }
+
+  return dist_vertices;
+}
+
+} // namespace legacy
+
+constexpr legacy::KeyPoints c_curved_key_points = {{
+    {-1.00f, -1.00f}, {-0.95f, -0.30f}, {-0.95f, 0.30f}, {-1.00f, 1.00f},
+    {-0.30f, -0.90f}, {-0.28f, -0.31f}, {-0.28f, 0.31f}, {-0.30f, 0.90f},
+    {0.30f, -0.90f}, {0.28f, -0.31f}, {0.28f, 0.31f}, {0.30f, 0.90f},
+    {1.00f, -1.00f}, {0.95f, -0.30f}, {0.95f, 0.30f}, {1.00f, 1.00f},
+}};
+
+// Evaluated at compile time, fails to build if the solver stops being
+// constexpr.
+constexpr auto c_constexpr_control_points =
+    warp::bezierControlPoints<4>({{0.f, 1.f, 2.f, 3.f}});
+static_assert(
+    c_constexpr_control_points.p1[0] > 0.f &&
+        c_constexpr_control_points.p2[2] < 3.f,
+    "bezierControlPoints is usable in constant expressions");
+
+float maxDifference(
+    const gles2::CMesh::Vertices& lhs,
+    const gles2::CMesh::Vertices& rhs)
+{
+  if (lhs.size() != rhs.size())
+  {
+    return INFINITY;
+  }
+
+  float diff = 0.f;
+  for (std::size_t i = 0; i < lhs.size(); ++i)
+  {
+    diff = std::max(diff, std::abs(lhs[i].position.x - rhs[i].position.x));
+    diff = std::max(diff, std::abs(lhs[i].position.y - rhs[i].position.y));
+    diff = std::max(diff, std::abs(lhs[i].text0.x - rhs[i].text0.x));
+    diff = std::max(diff, std::abs(lhs[i].text0.y - rhs[i].text0.y));
+  }
+  return diff;
+}
+
+} // namespace
+
+void benchBezier(CRunner& runner)
+{
+  const warp::KeyPoints curved_key_points{
+      {4u, 4u},
+      {c_curved_key_points.begin(), c_curved_key_points.end()},
+      {}};
+
+  for (std::size_t count : {30, 120, 512})
+  {
+    const std::string suffix = "/" + std::to_string(count);
+
+    Result* before = runner.run("bezier/legacy" + suffix, [&] {
+      auto vertices =
+          legacy::generateDistortionVertices(count, c_curved_key_points);
+      doNotOptimize(vertices.data());
+    });
+
+    gles2::CMesh::Vertices vertices;
+    Result* after = runner.run("bezier/table" + suffix, [&] {
+      warp::generateDistortionVertices(count, curved_key_points, vertices);
+      doNotOptimize(vertices.data());
+    });
+
+    if (after)
+    {
+      after->counters["vertices"] = static_cast<double>(vertices.size());
+      if (before)
+      {
+        after->counters["speedup"] = before->ns_per_iter / after->ns_per_iter;
+        after->counters["max_diff"] = maxDifference(
+            legacy::generateDistortionVertices(count, c_curved_key_points),
+            vertices);
+      }
+    }
+  }
+
+  runner.run("bezier/control_points", [&] {
+    std::array<float, 4> knots = {
+        c_curved_key_points[1].x,
+        c_curved_key_points[5].x,
+        c_curved_key_points[9].x,
+        c_curved_key_points[13].x};
+    doNotOptimize(knots.data());
+    auto cp = warp::bezierControlPoints(knots);
+    doNotOptimize(cp.p1.data());
+  });
+
+  // A row of the densest grids
+  runner.run("bezier/control_points/16", [&] {
+    std::array<float, 16> knots;
+    for (std::size_t i = 0; i < knots.size(); ++i)
+    {
+      knots[i] = c_curved_key_points[i].x;
+    }
+    doNotOptimize(knots.data());
+    auto cp = warp::bezierControlPoints(knots);
+    doNotOptimize(cp.p1.data());
+  });
+
+  // Denser control grids of curved screens
+  for (const glm::uvec2 grid_size : {glm::uvec2(8, 6), glm::uvec2(16, 9)})
+  {
+    const warp::KeyPoints kps = warp::makeDefaultKeyPoints(grid_size);
+    const std::string name = "bezier/grid" + std::to_string(grid_size.x) +
+                             "x" + std::to_string(grid_size.y) + "/512";
+
+    gles2::CMesh::Vertices vertices;
+    Result* result = runner.run(name, [&] {
+      warp::generateDistortionVertices(512, kps, vertices);
+      doNotOptimize(vertices.data());
+    });
+    if (result)
+    {
+      result->counters["vertices"] = static_cast<double>(vertices.size());
+    }
+  }
+
+  // Adaptive grids for a 1080p output, flat ones should stay at two
+  // triangles
+  const std::pair<const char*, warp::KeyPoints> surfaces[] = {
+      {"flat", warp::makeDefaultKeyPoints({4u, 4u})},
+      {"curved", curved_key_points},
+  };
+  for (auto&& [surface_name, kps] : surfaces)
+  {
+    for (const char* tolerance : {"0.5", "1", "2"})
+    {
+      const std::string name = std::string("bezier/adaptive/") +
+                               surface_name + "/" + tolerance + "px";
+      warp::Tessellation tessellation{};
+      Result* result = runner.run(name, [&] {
+        tessellation = warp::tessellateSurface(
+            warp::CSplineSurface(kps),
+            {1920u, 1080u},
+            std::stof(tolerance));
+        doNotOptimize(tessellation.us.data());
+      });
+      if (result)
+      {
+        result->counters["vertices"] = static_cast<double>(
+            tessellation.us.size() * tessellation.vs.size());
+        result->counters["max_error"] = tessellation.max_error;
+      }
+    }
+  }
+}
+
+} // namespace bench
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CRunner.hpp"
+
+#include <iomanip>
+#include <ostream>
+
+namespace bench {
+
+namespace {
+
+// Names and values are plain ASCII, only quotes and backslashes need it
+std::string quoted(const std::string& value)
+{
+  std::string out = "\"";
+  for (char c : value)
+  {
+    if (c == '"' || c == '\\')
+    {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out + "\"";
+}
+
+} // namespace
+
+CRunner::CRunner(std::string filter, double min_seconds)
+  : m_filter(std::move(filter))
+  , m_min_seconds(min_seconds)
+{
+}
+
+bool CRunner::enabled(const std::string& name) const
+{
+  return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+void CRunner::setInfo(const std::string& key, std::string value)
+{
+  m_info[key] = std::move(value);
+}
+
+void CRunner::writeJson(std::ostream& os) const
+{
+  const auto flags = os.flags();
+  os << std::setprecision(9) << "{\n  \"info\": {";
+  for (auto it = m_info.begin(); it != m_info.end(); ++it)
+  {
+    os << (it == m_info.begin() ? "" : ", ") << quoted(it->first) << ": "
+       << quoted(it->second);
+  }
+  os << "},\n  \"results\": [";
+  for (std::size_t i = 0; i < m_results.size(); ++i)
+  {
+    const Result& result = m_results[i];
+    os << (i ? ",\n" : "\n") << "    {\"name\": " << quoted(result.name)
+       << ", \"iterations\": " << result.iterations
+       << ", \"ns_per_iter\": " << result.ns_per_iter << ", \"counters\": {";
+    for (auto it = result.counters.begin(); it != result.counters.end(); ++it)
+    {
+      os << (it == result.counters.begin() ? "" : ", ") << quoted(it->first)
+         << ": " << it->second;
+    }
+    os << "}}";
+  }
+  os << "\n  ]\n}\n";
+  os.flags(flags);
+}
+
+} // namespace bench
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+/// Keeps the compiler from discarding the computation behind @p p.
+template <typename T>
+inline void doNotOptimize(T* p)
+{
+  asm volatile("" : : "g"(p) : "memory");
+}
+
+struct Result
+{
+  std::string name;
+  std::size_t iterations;
+  double ns_per_iter;
+  std::map<std::string, double> counters;
+};
+
+/// Minimal benchmark driver: repeats a body until it ran for at least the
+/// minimal time and keeps the results for the report.
+class CRunner
+{
+public:
+  explicit CRunner(std::string filter, double min_seconds = 0.25);
+
+  bool enabled(const std::string& name) const;
+
+  template <typename F>
+  Result* run(const std::string& name, F&& body);
+
+  const std::vector<Result>& results() const { return m_results; }
+
+  /// Describes the run, like the GL renderer, in the JSON report.
+  void setInfo(const std::string& key, std::string value);
+
+  /// Machine readable report, comparable across releases: the info and
+  /// every result with its counters.
+  void writeJson(std::ostream& os) const;
+
+private:
+  std::string m_filter;
+  double m_min_seconds;
+  std::vector<Result> m_results;
+  std::map<std::string, std::string> m_info;
+};
+
+template <typename F>
+Result* CRunner::run(const std::string& name, F&& body)
+{
+  if (!enabled(name))
+  {
+    return nullptr;
+  }
+
+  using clock = std::chrono::steady_clock;
+  body();
+
+  std::size_t iterations = 1;
+  std::chrono::duration<double> elapsed{0.};
+  for (;;)
+  {
+    const auto start = clock::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+      body();
+    }
+    elapsed = clock::now() - start;
+    if (elapsed.count() >= m_min_seconds)
+    {
+      break;
+    }
+    iterations *= 2;
+  }
+
+  m_results.push_back(
+      {name, iterations, elapsed.count() * 1e9 / iterations, {}});
+  return &m_results.back();
+}
+
+} // namespace bench
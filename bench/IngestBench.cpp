@@ -0,0 +1,260 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <FreeImage.h>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CTexture2D.hpp"
+#include "gles2/Etc.hpp"
+#include "gles2/Ktx.hpp"
+#include "gles2/Swizzle.hpp"
+
+namespace bench {
+
+namespace {
+
+struct Resolution
+{
+  const char* name;
+  glm::uvec2 size;
+};
+
+constexpr std::array<Resolution, 3> c_resolutions = {{
+    {"1080p", {1920u, 1080u}},
+    {"4k", {3840u, 2160u}},
+    {"8k", {7680u, 4320u}},
+}};
+
+// The channel swap CTexture2D::load did before the SIMD version
+void legacySwapRedBlue(uint8_t* pixels, const glm::uvec2& size, unsigned bpp)
+{
+  for (unsigned y = 0; y < size.y; y++)
+  {
+    uint8_t* line = pixels + std::size_t{y} * size.x * (bpp / 8);
+    for (unsigned x = 0; x < size.x; x++)
+    {
+      std::swap(line[FI_RGBA_RED], line[FI_RGBA_BLUE]);
+      line += bpp / 8;
+    }
+  }
+}
+
+void setThroughput(Result* result, const glm::uvec2& size)
+{
+  if (result)
+  {
+    result->counters["mpix_per_s"] =
+        1e3 * size.x * size.y / result->ns_per_iter;
+  }
+}
+
+struct FileFormat
+{
+  const char* name;
+  FREE_IMAGE_FORMAT fif;
+  bool alpha;
+};
+
+// Uncompressed BMP keeps decoding cheap next to the swap and the upload,
+// PNG and JPEG show what decoding adds
+constexpr std::array<FileFormat, 3> c_file_formats = {{
+    {"bmp", FIF_BMP, true},
+    {"png", FIF_PNG, true},
+    {"jpg", FIF_JPEG, false},
+}};
+
+// Whole CTexture2D::load of a file in @p format
+void benchLoad(
+    CRunner& runner,
+    const std::string& name,
+    const FileFormat& format,
+    const glm::uvec2& size,
+    unsigned bpp)
+{
+  if (!runner.enabled(name) || (32 == bpp && !format.alpha))
+  {
+    return;
+  }
+
+  const auto path =
+      std::filesystem::temp_directory_path() /
+      ("ingest_bench_" + std::to_string(bpp) + "." + format.name);
+  FIBITMAP* bitmap = FreeImage_Allocate(size.x, size.y, bpp);
+  const bool saved = FreeImage_Save(format.fif, bitmap, path.c_str());
+  FreeImage_Unload(bitmap);
+  if (!saved)
+  {
+    return;
+  }
+
+  setThroughput(
+      runner.run(
+          name,
+          [&] {
+            gles2::CTexture2D texture = gles2::CTexture2D::load(path.string());
+            glFinish();
+          }),
+      size);
+  std::filesystem::remove(path);
+}
+
+// CTexture2D::load of a KTX file, ETC1 for 24 bit and ETC2 with alpha for
+// 32 bit images. The blocks are all zero, uploads don't look at them
+void benchLoadKtx(
+    CRunner& runner,
+    const std::string& name,
+    const glm::uvec2& size,
+    unsigned bpp)
+{
+  const GLenum format =
+      (24 == bpp) ? gles2::c_etc1_rgb8 : gles2::c_etc2_rgba8_eac;
+  if (!runner.enabled(name) || !gles2::CTexture2D::canCompress(format))
+  {
+    return;
+  }
+
+  const auto path = std::filesystem::temp_directory_path() /
+                    ("ingest_bench_" + std::to_string(bpp) + ".ktx");
+  const std::size_t bytes = gles2::etcLevelBytes(format, size);
+  gles2::writeKtx(
+      path.string(),
+      {size,
+       size,
+       static_cast<GLint>(format),
+       std::vector<uint8_t>(bytes),
+       {bytes}});
+
+  Result* result = runner.run(name, [&] {
+    gles2::CTexture2D texture = gles2::CTexture2D::load(path.string());
+    glFinish();
+  });
+  setThroughput(result, size);
+  if (result)
+  {
+    result->counters["ratio"] =
+        double(std::size_t{size.x} * size.y * bpp / 8) / bytes;
+  }
+  std::filesystem::remove(path);
+}
+
+} // namespace
+
+void benchIngest(CRunner& runner)
+{
+  const gles2::SwapRedBlueFn swap_red_blue = gles2::selectSwapRedBlue();
+  const std::string simd = gles2::swapRedBlueName(swap_red_blue);
+
+  std::optional<egl::CContext> context;
+  for (const Resolution& resolution : c_resolutions)
+  {
+    const glm::uvec2& size = resolution.size;
+    for (unsigned bpp : {24u, 32u})
+    {
+      const std::string suffix =
+          "/" + std::to_string(bpp) + "bit/" + resolution.name;
+      std::vector<uint8_t> pixels(std::size_t{size.x} * size.y * bpp / 8);
+
+      Result* before = runner.run("ingest/swap/legacy" + suffix, [&] {
+        legacySwapRedBlue(pixels.data(), size, bpp);
+        doNotOptimize(pixels.data());
+      });
+      setThroughput(before, size);
+
+      Result* after = runner.run("ingest/swap/" + simd + suffix, [&] {
+        for (unsigned y = 0; y < size.y; ++y)
+        {
+          swap_red_blue(
+              pixels.data() + std::size_t{y} * size.x * (bpp / 8),
+              size.x,
+              bpp / 8);
+        }
+        doNotOptimize(pixels.data());
+      });
+      setThroughput(after, size);
+      if (before && after)
+      {
+        after->counters["speedup"] = before->ns_per_iter / after->ns_per_iter;
+      }
+
+      // Swap plus glTexImage2D, what an image switch costs once decoded
+      bool gl_needed = runner.enabled("ingest/upload" + suffix) ||
+                       runner.enabled("ingest/load/ktx" + suffix);
+      for (const FileFormat& format : c_file_formats)
+      {
+        gl_needed |=
+            runner.enabled(std::string("ingest/load/") + format.name + suffix);
+      }
+      if (!gl_needed)
+      {
+        continue;
+      }
+      if (!context)
+      {
+        context.emplace();
+        egl::CContext::makeCurrent(*context);
+      }
+      setThroughput(
+          runner.run(
+              "ingest/upload" + suffix,
+              [&] {
+                for (unsigned y = 0; y < size.y; ++y)
+                {
+                  swap_red_blue(
+                      pixels.data() + std::size_t{y} * size.x * (bpp / 8),
+                      size.x,
+                      bpp / 8);
+                }
+                gles2::CTexture2D texture(
+                    size, (bpp == 24) ? GL_RGB : GL_RGBA, pixels.data());
+                glFinish();
+              }),
+          size);
+      for (const FileFormat& format : c_file_formats)
+      {
+        benchLoad(
+            runner,
+            std::string("ingest/load/") + format.name + suffix,
+            format,
+            size,
+            bpp);
+      }
+      benchLoadKtx(runner, "ingest/load/ktx" + suffix, size, bpp);
+    }
+  }
+
+  if (context)
+  {
+    egl::CContext::release(*context);
+  }
+}
+
+} // namespace bench
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <GLES2/gl2.h>
+#include <glm/mat4x4.hpp>
+#include <string>
+#include <utility>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CFrameBuffer.hpp"
+#include "gles2/CMesh.hpp"
+#include "gles2/CShaderProgram.hpp"
+#include "gles2/CTexture2D.hpp"
+#include "video/SourceShader.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/EdgeBlend.hpp"
+#include "warp/Shaders.hpp"
+
+namespace bench {
+
+namespace {
+
+constexpr glm::uvec2 c_target_size{64u, 64u};
+constexpr std::size_t c_draws_per_iter = 20;
+
+// Small enough for the fragment work to stay negligible, so the draws
+// measure what the driver spends per call and per vertex
+void benchDraws(
+    CRunner& runner,
+    const std::string& suffix,
+    gles2::CMesh& mesh,
+    gles2::CShaderProgram& program)
+{
+  Result* result = runner.run("draw/submit" + suffix, [&] {
+    for (std::size_t i = 0; i < c_draws_per_iter; ++i)
+    {
+      mesh.draw(program);
+    }
+    glFinish();
+  });
+  if (result)
+  {
+    result->counters["draws_per_s"] =
+        1e9 * c_draws_per_iter / result->ns_per_iter;
+    result->counters["mvert_per_s"] = 1e3 * c_draws_per_iter *
+                                      mesh.getVertices().size() /
+                                      result->ns_per_iter;
+  }
+}
+
+} // namespace
+
+void benchMesh(CRunner& runner)
+{
+  if (!runner.enabled("mesh/") && !runner.enabled("draw/"))
+  {
+    return;
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  runner.setInfo(
+      "gl_renderer",
+      reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+  {
+    const warp::KeyPoints kps = warp::makeDefaultKeyPoints({4u, 4u});
+    warp::KeyPoints moved = kps;
+    moved.points[5] += glm::vec2(.01f);
+
+    gles2::CTexture2D source(c_target_size, GL_RGBA);
+    gles2::CTexture2D target(c_target_size, GL_RGBA);
+    gles2::CFrameBuffer frame_buffer(target);
+    gles2::CShaderProgram program(
+        warp::c_img_vshader_src,
+        video::sourceFragmentShader(
+            video::PixelFormat::Rgba, warp::c_img_fshader_src));
+
+    gles2::CFrameBuffer::bind(frame_buffer);
+    glViewport(0, 0, c_target_size.x, c_target_size.y);
+    gles2::CShaderProgram::use(program);
+    program.setUniform("u_mvp", glm::mat4(1.f));
+    video::setSourceUniforms(program, video::YuvMatrix::Bt601);
+    warp::setEdgeBlendUniforms(program, {}, false);
+    gles2::CTexture2D::bind(source);
+
+    for (std::size_t count : {30, 120, 512})
+    {
+      const std::string suffix = "/" + std::to_string(count);
+      const gles2::CMesh::Vertices vertices =
+          warp::generateDistortionVertices(count, kps);
+      const gles2::CMesh::Indices indices =
+          warp::generateDistortionIndices(count, kps.size);
+
+      // Evaluation, index generation and upload of a new mesh
+      runner.run("mesh/generate" + suffix, [&] {
+        gles2::CMesh mesh = warp::generateDistortionMesh(count, kps);
+        glFinish();
+      });
+      runner.run("mesh/construct" + suffix, [&] {
+        gles2::CMesh mesh(vertices, indices);
+        glFinish();
+      });
+
+      // What moving a key point costs interactively
+      gles2::CMesh mesh =
+          warp::generateDistortionMesh(count, kps, GL_DYNAMIC_DRAW);
+      bool toggle = false;
+      Result* update = runner.run("mesh/update" + suffix, [&] {
+        toggle = !toggle;
+        warp::updateDistortionMesh(mesh, count, toggle ? moved : kps);
+        glFinish();
+      });
+      if (update)
+      {
+        update->counters["vertices"] =
+            static_cast<double>(mesh.getVertices().size());
+      }
+
+      benchDraws(runner, suffix, mesh, program);
+    }
+    gles2::CFrameBuffer::unbind();
+  }
+  egl::CContext::release(context);
+}
+
+} // namespace bench
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <cstdint>
+#include <glm/mat4x4.hpp>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CFrameBuffer.hpp"
+#include "gles2/CMesh.hpp"
+#include "gles2/CShaderProgram.hpp"
+#include "gles2/CTexture2D.hpp"
+#include "video/SourceShader.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/EdgeBlend.hpp"
+#include "warp/Shaders.hpp"
+
+namespace bench {
+
+namespace {
+
+constexpr glm::uvec2 c_source_size{3840u, 2160u};
+constexpr glm::uvec2 c_target_size{1920u, 1080u};
+
+// Uncorrelated texels, so minified reads don't hit neighbouring cache lines
+std::vector<uint8_t> makeNoise(const glm::uvec2& size)
+{
+  std::vector<uint8_t> pixels(std::size_t{size.x} * size.y * 4);
+  uint32_t state = 0x12345678u;
+  for (uint8_t& value : pixels)
+  {
+    state = state * 1664525u + 1013904223u;
+    value = static_cast<uint8_t>(state >> 24);
+  }
+  return pixels;
+}
+
+} // namespace
+
+void benchSampling(CRunner& runner)
+{
+  if (!runner.enabled("sampling/"))
+  {
+    return;
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  {
+    const std::vector<uint8_t> noise = makeNoise(c_source_size);
+    gles2::CTexture2D linear(c_source_size, GL_RGBA, noise.data());
+    gles2::CTexture2D trilinear(c_source_size, GL_RGBA, noise.data());
+    trilinear.generateMipmaps();
+
+    gles2::CTexture2D target(c_target_size, GL_RGBA);
+    gles2::CFrameBuffer frame_buffer(target);
+    gles2::CMesh quad = warp::generateQuadMesh();
+    gles2::CShaderProgram program(
+        warp::c_img_vshader_src,
+        video::sourceFragmentShader(
+            video::PixelFormat::Rgba, warp::c_img_fshader_src));
+    const auto mvp = program.uniform<glm::mat4>("u_mvp");
+
+    gles2::CFrameBuffer::bind(frame_buffer);
+    glViewport(0, 0, c_target_size.x, c_target_size.y);
+    gles2::CShaderProgram::use(program);
+    program.setUniform("u_tex", 0);
+    warp::setEdgeBlendUniforms(program, {}, false);
+
+    for (float zoom : {1.f, .5f, .25f, .125f})
+    {
+      glm::mat4 scale(zoom);
+      scale[3][3] = 1.f;
+      const double fragments =
+          zoom * zoom * c_target_size.x * c_target_size.y;
+      const std::string suffix = "/zoom" + std::to_string(zoom).substr(0, 5);
+
+      for (const auto& [name, texture] :
+           {std::pair<const char*, const gles2::CTexture2D*>{
+                "linear", &linear},
+            {"trilinear", &trilinear}})
+      {
+        // Every draw covers the same pixels, no clear needed in between
+        Result* result =
+            runner.run(std::string("sampling/") + name + suffix, [&] {
+              program.setUniform(mvp, scale);
+              gles2::CTexture2D::bind(*texture);
+              quad.draw(program);
+              glFinish();
+            });
+        if (result)
+        {
+          result->counters["mfrag_per_s"] =
+              1e3 * fragments / result->ns_per_iter;
+        }
+      }
+    }
+    gles2::CFrameBuffer::unbind();
+  }
+  egl::CContext::release(context);
+}
+
+} // namespace bench
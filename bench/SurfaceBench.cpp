@@ -0,0 +1,226 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <GLES2/gl2.h>
+#include <algorithm>
+#include <cmath>
+#include <glm/mat4x4.hpp>
+#include <string>
+#include <vector>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CFrameBuffer.hpp"
+#include "gles2/CMesh.hpp"
+#include "gles2/CShaderProgram.hpp"
+#include "gles2/CTexture2D.hpp"
+#include "video/SourceShader.hpp"
+#include "warp/CSplineSurface.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/EdgeBlend.hpp"
+#include "warp/Shaders.hpp"
+#include "warp/SurfaceShader.hpp"
+
+namespace bench {
+
+namespace {
+
+constexpr glm::uvec2 c_target_size{64u, 64u};
+constexpr std::size_t c_draws_per_iter = 20;
+/// Pixels per row of the position readback.
+constexpr std::size_t c_check_width = 256;
+
+// Every vertex becomes the point on the pixel of its index, which holds
+// the evaluated position as 16 bits per axis over [-2, 2]
+constexpr char c_check_vshader_src[] = R"(
+  attribute vec3 a_pos;
+  attribute vec2 a_tex0;
+  varying vec2 v_pos;
+
+  void main() {
+    v_pos = evaluateSurface(a_tex0);
+    gl_PointSize = 1.0;
+    gl_Position = vec4(a_pos, 1.0);
+  }
+)";
+
+constexpr char c_check_fshader_src[] = R"(
+  precision highp float;
+  varying vec2 v_pos;
+
+  vec2 encode(float value) {
+    float n = floor(clamp((value + 2.0) / 4.0, 0.0, 1.0) * 65535.0 + 0.5);
+    float high = floor(n / 256.0);
+    return vec2(high, n - high * 256.0) / 255.0;
+  }
+
+  void main() {
+    gl_FragColor = vec4(encode(v_pos.x), encode(v_pos.y));
+  }
+)";
+
+float decode(const uint8_t* bytes)
+{
+  return (bytes[0] * 256 + bytes[1]) / 65535.f * 4.f - 2.f;
+}
+
+/// A 4x4 grid bent like a curved screen.
+warp::KeyPoints makeCurvedKeyPoints()
+{
+  warp::KeyPoints kps = warp::makeDefaultKeyPoints({4u, 4u});
+  for (glm::vec2& p : kps.points)
+  {
+    p = glm::vec2(p.x * (1.f - .08f * p.y * p.y), p.y * (.9f + .05f * p.x));
+  }
+  return kps;
+}
+
+/// Largest distance between the positions the surface shaders evaluate at
+/// the parameters of @p reference and the CPU evaluated ones.
+float checkSurface(
+    gles2::CShaderProgram& program,
+    const warp::KeyPoints& kps,
+    const gles2::CMesh::Vertices& reference)
+{
+  const glm::uvec2 size(
+      c_check_width, (reference.size() + c_check_width - 1) / c_check_width);
+  gles2::CMesh::Vertices vertices;
+  gles2::CMesh::Indices indices;
+  for (std::size_t i = 0; i < reference.size(); ++i)
+  {
+    const glm::vec2 pixel(i % size.x + .5f, i / size.x + .5f);
+    vertices.push_back(
+        {glm::vec3(pixel / glm::vec2(size) * 2.f - 1.f, 0.f),
+         reference[i].text0});
+    indices.push_back(static_cast<uint32_t>(i));
+  }
+  gles2::CMesh mesh(std::move(vertices), std::move(indices));
+
+  gles2::CTexture2D target(size, GL_RGBA, nullptr, GL_NEAREST);
+  gles2::CFrameBuffer frame_buffer(target);
+  gles2::CFrameBuffer::bind(frame_buffer);
+  glViewport(0, 0, size.x, size.y);
+  gles2::CShaderProgram::use(program);
+  warp::setSurfaceUniforms(program, warp::CSplineSurface(kps));
+  mesh.draw(program, true);
+
+  std::vector<uint8_t> pixels(size.x * size.y * 4);
+  glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  gles2::CFrameBuffer::unbind();
+
+  float diff = 0.f;
+  for (std::size_t i = 0; i < reference.size(); ++i)
+  {
+    const uint8_t* pixel = &pixels[i * 4];
+    diff = std::max(
+        diff, std::abs(decode(pixel) - reference[i].position.x));
+    diff = std::max(
+        diff, std::abs(decode(pixel + 2) - reference[i].position.y));
+  }
+  return diff;
+}
+
+} // namespace
+
+void benchSurface(CRunner& runner)
+{
+  if (!runner.enabled("surface/"))
+  {
+    return;
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  {
+    const warp::KeyPoints kps = makeCurvedKeyPoints();
+    warp::KeyPoints moved = kps;
+    moved.points[5] += glm::vec2(.01f);
+
+    gles2::CShaderProgram check_program(
+        warp::surfaceVertexShader(c_check_vshader_src), c_check_fshader_src);
+
+    gles2::CTexture2D source(c_target_size, GL_RGBA);
+    gles2::CTexture2D target(c_target_size, GL_RGBA);
+    gles2::CFrameBuffer frame_buffer(target);
+    gles2::CShaderProgram program(
+        warp::surfaceVertexShader(),
+        video::sourceFragmentShader(
+            video::PixelFormat::Rgba, warp::c_img_fshader_src));
+
+    for (std::size_t count : {30, 120})
+    {
+      const std::string suffix = "/" + std::to_string(count);
+
+      // Both paths have to place the vertices alike, the 16 bit readback
+      // resolves 6e-5
+      const gles2::CMesh::Vertices reference =
+          warp::generateDistortionVertices(count, kps);
+      float max_diff = 0.f;
+      Result* check = runner.run("surface/check" + suffix, [&] {
+        max_diff = checkSurface(check_program, kps, reference);
+      });
+      if (check)
+      {
+        check->counters["max_diff"] = max_diff;
+      }
+
+      // What moving a key point costs, against mesh/update
+      gles2::CFrameBuffer::bind(frame_buffer);
+      glViewport(0, 0, c_target_size.x, c_target_size.y);
+      gles2::CShaderProgram::use(program);
+      program.setUniform("u_mvp", glm::mat4(1.f));
+      video::setSourceUniforms(program, video::YuvMatrix::Bt601);
+      warp::setEdgeBlendUniforms(program, {}, false);
+      gles2::CTexture2D::bind(source);
+
+      gles2::CMesh mesh = warp::generateParameterMesh(count, kps.size);
+      bool toggle = false;
+      runner.run("surface/update" + suffix, [&] {
+        toggle = !toggle;
+        warp::setSurfaceUniforms(
+            program, warp::CSplineSurface(toggle ? moved : kps));
+        glFinish();
+      });
+
+      // Against draw/submit, the vertex shader does the evaluation
+      Result* draw = runner.run("surface/draw" + suffix, [&] {
+        for (std::size_t i = 0; i < c_draws_per_iter; ++i)
+        {
+          mesh.draw(program);
+        }
+        glFinish();
+      });
+      if (draw)
+      {
+        draw->counters["mvert_per_s"] = 1e3 * c_draws_per_iter *
+                                        mesh.getVertices().size() /
+                                        draw->ns_per_iter;
+      }
+      gles2::CFrameBuffer::unbind();
+    }
+  }
+  egl::CContext::release(context);
+}
+
+} // namespace bench
@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "CRunner.hpp"
+#include "Suites.hpp"
+
+int main(int argc, const char** argv)
+{
+  // [--json <file>] [filter], - writes the JSON report to stdout
+  std::string json_path;
+  std::string filter;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string_view(argv[i]) == "--json" && i + 1 < argc)
+    {
+      json_path = argv[++i];
+    }
+    else
+    {
+      filter = argv[i];
+    }
+  }
+  bench::CRunner runner(filter);
+
+  bench::benchBezier(runner);
+  bench::benchIngest(runner);
+  bench::benchMesh(runner);
+  bench::benchSampling(runner);
+  bench::benchSurface(runner);
+
+  // The table moves out of the way of a JSON report on stdout
+  std::ostream& table = (json_path == "-") ? std::cerr : std::cout;
+  for (auto&& result : runner.results())
+  {
+    table << std::left << std::setw(40) << result.name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(1)
+              << result.ns_per_iter << " ns";
+    for (auto && [ key, value ] : result.counters)
+    {
+      table << "  " << key << "=" << std::defaultfloat
+                << std::setprecision(6) << value;
+    }
+    table << std::endl;
+  }
+
+  if (json_path == "-")
+  {
+    runner.writeJson(std::cout);
+  }
+  else if (!json_path.empty())
+  {
+    std::ofstream file(json_path);
+    runner.writeJson(file);
+    if (!file)
+    {
+      std::cerr << "Couldn't write " << json_path << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
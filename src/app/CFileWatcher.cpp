@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CFileWatcher.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace app {
+
+namespace {
+
+// Complete files arrive closed or renamed into place, a modification only
+// tells that a writer is busy with the file again
+constexpr uint32_t c_done_events = IN_CLOSE_WRITE | IN_MOVED_TO;
+constexpr uint32_t c_write_events = c_done_events | IN_MODIFY;
+
+} // namespace
+
+CFileWatcher::CFileWatcher(
+    const std::vector<std::string>& paths,
+    std::function<void()> on_change,
+    Clock::duration settle)
+  : m_on_change(std::move(on_change))
+  , m_settle(settle)
+  , m_inotify_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+  , m_stop_fd(eventfd(0, EFD_CLOEXEC))
+  , m_changed(paths.size(), false)
+{
+  if (m_inotify_fd < 0 || m_stop_fd < 0)
+  {
+    const std::string error = std::strerror(errno);
+    if (m_inotify_fd >= 0)
+    {
+      close(m_inotify_fd);
+    }
+    if (m_stop_fd >= 0)
+    {
+      close(m_stop_fd);
+    }
+    throw FileWatchError("can't watch files: " + error);
+  }
+
+  for (auto&& path : paths)
+  {
+    std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    if (dir.empty())
+    {
+      dir = ".";
+    }
+    // Files of one directory share its watch descriptor
+    const int wd = inotify_add_watch(m_inotify_fd, dir.c_str(), c_write_events);
+    if (wd < 0)
+    {
+      const std::string error = std::strerror(errno);
+      close(m_inotify_fd);
+      close(m_stop_fd);
+      throw FileWatchError("can't watch " + dir.string() + ": " + error);
+    }
+    m_watched.push_back(
+        {std::filesystem::path(path).filename(), wd, false, Clock::now()});
+  }
+
+  m_thread = std::thread(&CFileWatcher::run, this);
+}
+
+CFileWatcher::~CFileWatcher()
+{
+  const uint64_t stop = 1;
+  if (write(m_stop_fd, &stop, sizeof(stop)) == sizeof(stop))
+  {
+    m_thread.join();
+  }
+  else
+  {
+    m_thread.detach();
+  }
+  close(m_inotify_fd);
+  close(m_stop_fd);
+}
+
+std::vector<std::size_t> CFileWatcher::takeChanged()
+{
+  std::vector<std::size_t> changed;
+  std::lock_guard lock(m_mutex);
+  for (std::size_t i = 0; i < m_changed.size(); ++i)
+  {
+    if (m_changed[i])
+    {
+      changed.push_back(i);
+      m_changed[i] = false;
+    }
+  }
+  return changed;
+}
+
+void CFileWatcher::run()
+{
+  for (;;)
+  {
+    // Sleep until an event, or until the next pending file settles
+    int timeout = -1;
+    const Clock::time_point now = Clock::now();
+    for (const Watched& watched : m_watched)
+    {
+      if (watched.pending)
+      {
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+            watched.last_write + m_settle - now);
+        const int ms = static_cast<int>(std::max<long long>(left.count(), 0));
+        timeout = (timeout < 0) ? ms : std::min(timeout, ms);
+      }
+    }
+
+    pollfd fds[] = {{m_inotify_fd, POLLIN, 0}, {m_stop_fd, POLLIN, 0}};
+    if (poll(fds, 2, timeout) < 0 && errno != EINTR)
+    {
+      return;
+    }
+    if (fds[1].revents)
+    {
+      return;
+    }
+    if (fds[0].revents & POLLIN)
+    {
+      readEvents();
+    }
+
+    bool settled = false;
+    {
+      const Clock::time_point then = Clock::now();
+      std::lock_guard lock(m_mutex);
+      for (std::size_t i = 0; i < m_watched.size(); ++i)
+      {
+        Watched& watched = m_watched[i];
+        if (watched.pending && then - watched.last_write >= m_settle)
+        {
+          watched.pending = false;
+          m_changed[i] = true;
+          settled = true;
+        }
+      }
+    }
+    if (settled && m_on_change)
+    {
+      m_on_change();
+    }
+  }
+}
+
+void CFileWatcher::readEvents()
+{
+  alignas(inotify_event) char buffer[4096];
+  for (;;)
+  {
+    const ssize_t size = read(m_inotify_fd, buffer, sizeof(buffer));
+    if (size <= 0)
+    {
+      return;
+    }
+    for (ssize_t offset = 0; offset < size;)
+    {
+      const auto* event =
+          reinterpret_cast<const inotify_event*>(buffer + offset);
+      offset += sizeof(inotify_event) + event->len;
+      if (0 == event->len)
+      {
+        continue;
+      }
+      for (Watched& watched : m_watched)
+      {
+        if (watched.wd == event->wd && watched.name == event->name)
+        {
+          watched.pending = (event->mask & c_done_events) != 0;
+          watched.last_write = Clock::now();
+        }
+      }
+    }
+  }
+}
+
+} // namespace app
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace app {
+
+struct FileWatchError : std::runtime_error
+{
+  using std::runtime_error::runtime_error;
+};
+
+/// Notices files rewritten by other processes, with inotify on a background
+/// thread. The directories are watched, so files replaced by a rename are
+/// seen too. A file counts as changed once a writer closed it or it was
+/// renamed into place, and nothing touched it for the settle time after,
+/// which merges bursts of them. Writes in between wait for the next close,
+/// a writer pausing halfway is never taken as done.
+class CFileWatcher
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @p on_change is called from the watcher thread whenever files
+  /// settled, to wake up a waiting main loop.
+  explicit CFileWatcher(
+      const std::vector<std::string>& paths,
+      std::function<void()> on_change = {},
+      Clock::duration settle = std::chrono::milliseconds(250));
+  CFileWatcher(const CFileWatcher&) = delete;
+  CFileWatcher& operator=(const CFileWatcher&) = delete;
+  ~CFileWatcher();
+
+  /// Indices into the paths changed since the last call, in order.
+  std::vector<std::size_t> takeChanged();
+
+private:
+  struct Watched
+  {
+    std::filesystem::path name;
+    int wd;
+    bool pending;
+    Clock::time_point last_write;
+  };
+
+  void run();
+  void readEvents();
+
+  std::function<void()> m_on_change;
+  Clock::duration m_settle;
+  int m_inotify_fd;
+  int m_stop_fd;
+  std::vector<Watched> m_watched;
+  std::mutex m_mutex;
+  std::vector<bool> m_changed;
+  std::thread m_thread;
+};
+
+} // namespace app
@@ -0,0 +1,173 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CFrameProfiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+
+namespace app {
+
+namespace {
+
+void writeStats(std::ostream& os, const char* key, const CRollingStats& stats)
+{
+  os << "\"" << key << "\": {\"samples\": " << stats.size()
+     << ", \"p50\": " << stats.percentile(50.)
+     << ", \"p95\": " << stats.percentile(95.)
+     << ", \"p99\": " << stats.percentile(99.) << ", \"max\": " << stats.max()
+     << "}";
+}
+
+double milliseconds(std::chrono::steady_clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+CFrameProfiler::CFrameProfiler(bool enabled)
+  : m_enabled(enabled)
+  , m_gpu(enabled && gles2::CTimerQuery::supported())
+  , m_num_frames(0)
+  , m_frame(0)
+  , m_running(0)
+{
+  m_frame = phase("frame", false);
+  m_running = m_frame;
+}
+
+CFrameProfiler::PhaseId CFrameProfiler::phase(const std::string& name, bool gpu)
+{
+  const auto it =
+      std::find_if(m_phases.begin(), m_phases.end(), [&](const Phase& p) {
+        return p.name == name;
+      });
+  if (it != m_phases.end())
+  {
+    return it - m_phases.begin();
+  }
+  m_phases.push_back({name, gpu && m_gpu, CRollingStats(), CRollingStats()});
+  return m_phases.size() - 1;
+}
+
+void CFrameProfiler::beginFrame()
+{
+  if (!m_enabled)
+  {
+    return;
+  }
+  collect();
+  m_frame_start = Clock::now();
+}
+
+void CFrameProfiler::endFrame()
+{
+  if (!m_enabled)
+  {
+    return;
+  }
+  m_phases[m_frame].cpu.add(milliseconds(Clock::now() - m_frame_start));
+  ++m_num_frames;
+}
+
+void CFrameProfiler::begin(PhaseId phase)
+{
+  if (!m_enabled)
+  {
+    return;
+  }
+  m_running = phase;
+  if (m_phases[phase].gpu)
+  {
+    if (m_free_queries.empty())
+    {
+      m_free_queries.emplace_back();
+    }
+    m_pending.push_back({phase, std::move(m_free_queries.back())});
+    m_free_queries.pop_back();
+    m_pending.back().query.begin();
+  }
+  m_phase_start = Clock::now();
+}
+
+void CFrameProfiler::end()
+{
+  if (!m_enabled)
+  {
+    return;
+  }
+  m_phases[m_running].cpu.add(milliseconds(Clock::now() - m_phase_start));
+  if (m_phases[m_running].gpu)
+  {
+    m_pending.back().query.end();
+  }
+}
+
+void CFrameProfiler::collect()
+{
+  if (!m_gpu)
+  {
+    return;
+  }
+  // Results arrive in order, a disjoint GPU clock spoils all pending ones
+  const bool disjoint = gles2::CTimerQuery::disjoint();
+  while (!m_pending.empty() && m_pending.front().query.available())
+  {
+    Pending& pending = m_pending.front();
+    if (!disjoint)
+    {
+      m_phases[pending.phase].gpu_stats.add(
+          pending.query.nanoseconds() * 1e-6);
+    }
+    m_free_queries.push_back(std::move(pending.query));
+    m_pending.pop_front();
+  }
+}
+
+void CFrameProfiler::write(std::ostream& os) const
+{
+  const auto flags = os.flags();
+  os << std::fixed << std::setprecision(3) << "{\"frames\": " << m_num_frames
+     << ", \"gpu_timer\": " << (m_gpu ? "true" : "false")
+     << ", \"phases\": {";
+  for (std::size_t i = 0; i < m_phases.size(); ++i)
+  {
+    const Phase& phase = m_phases[i];
+    os << (i ? ", " : "") << "\"" << phase.name << "\": {";
+    writeStats(os, "cpu_ms", phase.cpu);
+    if (phase.gpu)
+    {
+      os << ", ";
+      writeStats(os, "gpu_ms", phase.gpu_stats);
+    }
+    os << "}";
+  }
+  os << "}}\n";
+  os.flags(flags);
+}
+
+} // namespace app
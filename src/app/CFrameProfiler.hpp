@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "CRollingStats.hpp"
+#include "gles2/CTimerQuery.hpp"
+
+namespace app {
+
+/// Where the frame time goes: CPU time of each phase of the main loop and,
+/// with EXT_disjoint_timer_query, GPU time of the commands it issued.
+/// Phases don't nest, a disabled profiler costs a branch per call. Needs a
+/// current context for its whole life.
+class CFrameProfiler
+{
+public:
+  using PhaseId = std::size_t;
+
+  explicit CFrameProfiler(bool enabled);
+
+  bool enabled() const { return m_enabled; }
+  bool gpuTimed() const { return m_gpu; }
+
+  /// Registers a phase, @p gpu times its commands as well. Names are keys
+  /// of the report, registering one again returns the same phase.
+  PhaseId phase(const std::string& name, bool gpu = true);
+
+  /// Collects GPU times of earlier frames, which never stalls.
+  void beginFrame();
+  void endFrame();
+
+  void begin(PhaseId phase);
+  void end();
+
+  /// JSON object with the frame count and, per phase, sample counts and
+  /// p50/p95/p99/max in milliseconds of the "cpu_ms" and "gpu_ms" windows.
+  void write(std::ostream& os) const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Phase
+  {
+    std::string name;
+    bool gpu;
+    CRollingStats cpu;
+    CRollingStats gpu_stats;
+  };
+
+  struct Pending
+  {
+    PhaseId phase;
+    gles2::CTimerQuery query;
+  };
+
+  void collect();
+
+  bool m_enabled;
+  bool m_gpu;
+  std::size_t m_num_frames;
+  std::vector<Phase> m_phases;
+  PhaseId m_frame;
+  PhaseId m_running;
+  Clock::time_point m_frame_start;
+  Clock::time_point m_phase_start;
+  std::deque<Pending> m_pending;
+  std::vector<gles2::CTimerQuery> m_free_queries;
+};
+
+} // namespace app
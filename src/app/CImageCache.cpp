@@ -0,0 +1,259 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CImageCache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace app {
+
+namespace {
+
+constexpr std::size_t c_max_threads = 4;
+
+} // namespace
+
+CImageCache::CImageCache(
+    std::vector<std::string> paths,
+    std::size_t budget_bytes,
+    bool mipmaps,
+    std::function<void()> on_decoded,
+    std::size_t num_threads)
+  : m_budget_bytes(budget_bytes)
+  , m_mipmaps(mipmaps)
+  , m_pot_only(mipmaps && !gles2::CTexture2D::canMipmapNpot())
+  , m_on_decoded(std::move(on_decoded))
+  , m_entries(paths.size())
+  , m_shown(paths.size())
+  , m_clock(0)
+  , m_current(paths.size())
+  , m_stop(false)
+{
+  for (std::size_t i = 0; i < paths.size(); ++i)
+  {
+    m_entries[i].path = std::move(paths[i]);
+  }
+
+  if (0 == num_threads)
+  {
+    num_threads = std::clamp<std::size_t>(
+        std::thread::hardware_concurrency(), 1, c_max_threads);
+  }
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    m_workers.emplace_back(&CImageCache::work, this);
+  }
+}
+
+CImageCache::~CImageCache()
+{
+  {
+    std::lock_guard lock(m_mutex);
+    m_stop = true;
+  }
+  m_queued.notify_all();
+  for (auto&& worker : m_workers)
+  {
+    worker.join();
+  }
+}
+
+const gles2::CTexture2D* CImageCache::get(std::size_t index)
+{
+  Entry& entry = m_entries.at(index);
+  entry.last_use = ++m_clock;
+  select(index);
+  if (entry.texture)
+  {
+    m_shown = index;
+    return &*entry.texture;
+  }
+
+  std::optional<gles2::CTexture2D::Decoded> decoded;
+  {
+    std::lock_guard lock(m_mutex);
+    if (State::Decoded == entry.state)
+    {
+      decoded = std::move(entry.decoded);
+      entry.decoded.reset();
+      entry.state = State::Idle;
+    }
+    else if (State::Failed == entry.state)
+    {
+      m_shown = index;
+      return nullptr;
+    }
+  }
+  if (!decoded)
+  {
+    return shown();
+  }
+
+  // Evicting first keeps the peak within the budget, a full mip chain adds
+  // a third unless a compressed image brings its own
+  m_shown = index;
+  const std::size_t bytes = decoded->pixels.size();
+  evictFor(
+      (m_mipmaps && decoded->levels.empty()) ? bytes + bytes / 3 : bytes,
+      index);
+  try
+  {
+    entry.texture.emplace(gles2::CTexture2D::upload(*decoded, m_mipmaps));
+  }
+  catch (const gles2::TextureLoadError&)
+  {
+    std::lock_guard lock(m_mutex);
+    entry.state = State::Failed;
+    return nullptr;
+  }
+  entry.bytes = entry.texture->bytes();
+  ++m_stats.resident;
+  ++m_stats.uploads;
+  m_stats.resident_bytes += entry.bytes;
+  return &*entry.texture;
+}
+
+bool CImageCache::selectedDecoded()
+{
+  std::lock_guard lock(m_mutex);
+  if (m_current == m_entries.size() || m_current == m_shown)
+  {
+    return false;
+  }
+  const State state = m_entries[m_current].state;
+  return State::Decoded == state || State::Failed == state;
+}
+
+const gles2::CTexture2D* CImageCache::shown() const
+{
+  if (m_shown < m_entries.size() && m_entries[m_shown].texture)
+  {
+    return &*m_entries[m_shown].texture;
+  }
+  return nullptr;
+}
+
+void CImageCache::select(std::size_t index)
+{
+  std::lock_guard lock(m_mutex);
+  if (index == m_current)
+  {
+    return;
+  }
+  m_current = index;
+
+  const std::size_t count = m_entries.size();
+  const std::size_t next = (index + 1) % count;
+  const std::size_t prev = (index + count - 1) % count;
+
+  // Images the selection moved away from are not worth decoding or holding
+  m_queue.clear();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Entry& entry = m_entries[i];
+    if (State::Queued == entry.state ||
+        (i != index && i != next && i != prev &&
+         State::Decoded == entry.state))
+    {
+      entry.decoded.reset();
+      entry.state = State::Idle;
+    }
+  }
+  for (std::size_t i : {index, next, prev})
+  {
+    Entry& entry = m_entries[i];
+    if (!entry.texture && State::Idle == entry.state)
+    {
+      entry.state = State::Queued;
+      m_queue.push_back(i);
+      m_queued.notify_one();
+    }
+  }
+}
+
+void CImageCache::evictFor(std::size_t bytes, std::size_t keep)
+{
+  while (m_stats.resident_bytes + bytes > m_budget_bytes)
+  {
+    Entry* oldest = nullptr;
+    for (std::size_t i = 0; i < m_entries.size(); ++i)
+    {
+      Entry& entry = m_entries[i];
+      if (i != keep && entry.texture &&
+          (!oldest || entry.last_use < oldest->last_use))
+      {
+        oldest = &entry;
+      }
+    }
+    if (!oldest)
+    {
+      return;
+    }
+    oldest->texture.reset();
+    --m_stats.resident;
+    m_stats.resident_bytes -= oldest->bytes;
+    ++m_stats.evictions;
+  }
+}
+
+void CImageCache::work()
+{
+  std::unique_lock lock(m_mutex);
+  for (;;)
+  {
+    m_queued.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+    if (m_stop)
+    {
+      return;
+    }
+    const std::size_t index = m_queue.front();
+    m_queue.pop_front();
+    Entry& entry = m_entries[index];
+    entry.state = State::Decoding;
+    const std::string path = entry.path;
+
+    lock.unlock();
+    std::optional<gles2::CTexture2D::Decoded> decoded;
+    try
+    {
+      decoded = gles2::CTexture2D::decode(path, m_pot_only);
+    }
+    catch (const gles2::TextureLoadError&)
+    {
+    }
+    lock.lock();
+
+    entry.state = decoded ? State::Decoded : State::Failed;
+    entry.decoded = std::move(decoded);
+    if (index == m_current && m_on_decoded)
+    {
+      lock.unlock();
+      m_on_decoded();
+      lock.lock();
+    }
+  }
+}
+
+} // namespace app
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gles2/CTexture2D.hpp"
+
+namespace app {
+
+/// Textures of an image playlist, loaded when first shown instead of all
+/// up front. Files are decoded by a pool of threads, the selected image
+/// first and its neighbours ahead of time, and uploaded on the GL thread,
+/// which never waits for them. Textures over the byte budget are evicted,
+/// least recently shown first. Needs a current context for its whole life.
+class CImageCache
+{
+public:
+  struct Stats
+  {
+    std::size_t resident = 0;
+    std::size_t resident_bytes = 0;
+    std::size_t uploads = 0;
+    std::size_t evictions = 0;
+  };
+
+  /// @p on_decoded is called from a decoding thread once the selected
+  /// image is decoded, to wake up a waiting main loop.
+  CImageCache(
+      std::vector<std::string> paths,
+      std::size_t budget_bytes,
+      bool mipmaps,
+      std::function<void()> on_decoded = {},
+      std::size_t num_threads = 0);
+  CImageCache(const CImageCache&) = delete;
+  CImageCache& operator=(const CImageCache&) = delete;
+  ~CImageCache();
+
+  std::size_t size() const { return m_entries.size(); }
+
+  /// Selects image @p index and returns its texture, uploading it once
+  /// decoded. Until then the image shown before stays, nullptr if there is
+  /// none or the file can't be loaded. Never decodes or waits, the image
+  /// is queued ahead of its neighbours instead.
+  const gles2::CTexture2D* get(std::size_t index);
+
+  /// Whether the selected image finished decoding since get() last saw
+  /// it, a frame showing the image before needs to be drawn again.
+  bool selectedDecoded();
+
+  const Stats& stats() const { return m_stats; }
+
+private:
+  enum class State
+  {
+    Idle,
+    Queued,
+    Decoding,
+    Decoded,
+    Failed,
+  };
+
+  struct Entry
+  {
+    std::string path;
+    State state = State::Idle;
+    std::optional<gles2::CTexture2D::Decoded> decoded;
+    std::optional<gles2::CTexture2D> texture;
+    std::size_t bytes = 0;
+    uint64_t last_use = 0;
+  };
+
+  void work();
+  /// Queues @p index and its neighbours, drops what is left of the others.
+  void select(std::size_t index);
+  const gles2::CTexture2D* shown() const;
+  void evictFor(std::size_t bytes, std::size_t keep);
+
+  const std::size_t m_budget_bytes;
+  const bool m_mipmaps;
+  const bool m_pot_only;
+  std::function<void()> m_on_decoded;
+  std::vector<Entry> m_entries;
+  /// Index of the image get() returned last, size() for none.
+  std::size_t m_shown;
+  uint64_t m_clock;
+  Stats m_stats;
+
+  // Entry states, decoded images and the selection are shared with the
+  // workers
+  std::mutex m_mutex;
+  std::size_t m_current;
+  std::condition_variable m_queued;
+  std::deque<std::size_t> m_queue;
+  bool m_stop;
+  std::vector<std::thread> m_workers;
+};
+
+} // namespace app
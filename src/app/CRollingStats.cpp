@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CRollingStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace app {
+
+CRollingStats::CRollingStats(std::size_t capacity)
+  : m_capacity(std::max<std::size_t>(capacity, 1))
+  , m_next(0)
+  , m_total(0)
+{
+  m_samples.reserve(m_capacity);
+}
+
+void CRollingStats::add(double value)
+{
+  if (m_samples.size() < m_capacity)
+  {
+    m_samples.push_back(value);
+  }
+  else
+  {
+    m_samples[m_next] = value;
+  }
+  m_next = (m_next + 1) % m_capacity;
+  ++m_total;
+}
+
+double CRollingStats::percentile(double p) const
+{
+  if (m_samples.empty())
+  {
+    return 0.;
+  }
+  const double rank = std::ceil(p / 100. * m_samples.size());
+  const std::size_t index = static_cast<std::size_t>(
+      std::clamp(rank, 1., static_cast<double>(m_samples.size())) - 1);
+  m_sorted = m_samples;
+  std::nth_element(m_sorted.begin(), m_sorted.begin() + index, m_sorted.end());
+  return m_sorted[index];
+}
+
+double CRollingStats::max() const
+{
+  return m_samples.empty()
+             ? 0.
+             : *std::max_element(m_samples.begin(), m_samples.end());
+}
+
+double CRollingStats::mean() const
+{
+  return m_samples.empty()
+             ? 0.
+             : std::accumulate(m_samples.begin(), m_samples.end(), 0.) /
+                   m_samples.size();
+}
+
+} // namespace app
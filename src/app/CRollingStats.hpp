@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace app {
+
+/// The last @p capacity samples of a measurement, so percentiles follow
+/// recent behaviour instead of averaging over the whole run.
+class CRollingStats
+{
+public:
+  explicit CRollingStats(std::size_t capacity = 1024);
+
+  void add(double value);
+
+  /// Samples in the window and added since construction.
+  std::size_t size() const { return m_samples.size(); }
+  std::size_t total() const { return m_total; }
+
+  /// Nearest rank percentile of the window, @p p in [0, 100]. 0 when empty.
+  double percentile(double p) const;
+  double max() const;
+  double mean() const;
+
+private:
+  std::size_t m_capacity;
+  std::size_t m_next;
+  std::size_t m_total;
+  std::vector<double> m_samples;
+  mutable std::vector<double> m_sorted;
+};
+
+} // namespace app
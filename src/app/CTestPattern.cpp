@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CTestPattern.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include "warp/DistortionMesh.hpp"
+#include "warp/Shaders.hpp"
+
+namespace app {
+
+CTestPattern::CTestPattern()
+  : m_quad(warp::generateQuadMesh())
+  , m_program(warp::c_img_vshader_src, warp::c_pattern_fshader_src)
+  , m_mvp(m_program.uniform<glm::mat4>("u_mvp"))
+  , m_size(m_program.uniform<glm::vec2>("u_size"))
+{
+}
+
+void CTestPattern::render(
+    gles2::CRenderTarget& target,
+    const glm::uvec2& size)
+{
+  target.resize(size);
+  gles2::CRenderTarget::bind(target);
+
+  gles2::CShaderProgram::use(m_program);
+  m_program.setUniform(m_mvp, glm::mat4(1.f));
+  m_program.setUniform(m_size, glm::vec2(size));
+  m_quad.draw(m_program);
+}
+
+} // namespace app
@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include "gles2/CMesh.hpp"
+#include "gles2/CRenderTarget.hpp"
+#include "gles2/CShaderProgram.hpp"
+
+namespace app {
+
+/// Content renderer drawing a calibration pattern into a render target,
+/// which is then warped like any image.
+class CTestPattern
+{
+public:
+  CTestPattern();
+
+  /// Draws into @p target, resized to @p size first. Leaves the target
+  /// bound.
+  void render(gles2::CRenderTarget& target, const glm::uvec2& size);
+
+private:
+  gles2::CMesh m_quad;
+  gles2::CShaderProgram m_program;
+  gles2::CShaderProgram::Uniform<glm::mat4> m_mvp;
+  gles2::CShaderProgram::Uniform<glm::vec2> m_size;
+};
+
+} // namespace app
@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CWarpRenderer.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <iostream>
+
+#include "gles2/CStateCache.hpp"
+#include "video/SourceShader.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/Shaders.hpp"
+#include "warp/SurfaceShader.hpp"
+
+namespace app {
+
+namespace {
+
+std::optional<warp::CSplineSurface> gpuSurface(
+    const Options& opts,
+    const warp::KeyPoints& key_points)
+{
+  if (!opts.gpu_surface)
+  {
+    return std::nullopt;
+  }
+  if (!warp::canEvaluateSurface(key_points.size))
+  {
+    std::cerr << "Grid is too big for the surface shaders, evaluate it on "
+                 "the CPU."
+              << std::endl;
+    return std::nullopt;
+  }
+  return warp::CSplineSurface(key_points);
+}
+
+} // namespace
+
+CWarpRenderer::CWarpRenderer(
+    const Options& opts,
+    const warp::KeyPoints& key_points,
+    const warp::CLutFile* lut,
+    video::PixelFormat source_format)
+  : m_lut(lut)
+  , m_yuv_matrix(opts.yuv_matrix)
+  , m_key_points(key_points)
+  , m_density{opts.num_points, opts.tolerance, glm::uvec2(0u)}
+  , m_mesh_error(0.f)
+  , m_surface(gpuSurface(opts, key_points))
+  , m_mesh(
+        lut || m_density.adaptive()
+            ? warp::generateQuadMesh()
+            : m_surface ? warp::generateParameterMesh(
+                              opts.num_points, key_points.size)
+                        : warp::generateDistortionMesh(
+                              opts.num_points, key_points))
+  , m_program(
+        m_surface ? warp::surfaceVertexShader()
+                  : std::string(warp::c_img_vshader_src),
+        video::sourceFragmentShader(
+            source_format,
+            lut ? warp::c_lut_fshader_src : warp::c_img_fshader_src))
+{
+  if (lut)
+  {
+    m_lut_texture.emplace(lut->upload());
+  }
+  if (!m_key_points.blend.mask_path.empty())
+  {
+    m_mask_texture.emplace(
+        gles2::CTexture2D::load(m_key_points.blend.mask_path));
+  }
+
+  gles2::CStateCache::current().enable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glBlendEquation(GL_FUNC_ADD);
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+void CWarpRenderer::draw(
+    const gles2::CTexture2D& source,
+    const glm::uvec2& size)
+{
+  bindTarget(size);
+  gles2::CTexture2D::bind(source);
+  drawMesh();
+}
+
+void CWarpRenderer::draw(
+    const video::CFrameUploader& source,
+    const glm::uvec2& size)
+{
+  bindTarget(size);
+  source.bind();
+  drawMesh();
+}
+
+void CWarpRenderer::bindTarget(const glm::uvec2& size)
+{
+  if (!m_lut && m_density.adaptive() && size != m_density.viewport)
+  {
+    m_density.viewport = size;
+    m_mesh = warp::generateDistortionMesh(
+        m_density, m_key_points, GL_STATIC_DRAW, &m_mesh_error);
+  }
+
+  // A new target texture takes unit 0, so sources are bound after it
+  m_target.resize(size);
+  gles2::CRenderTarget::bind(m_target);
+  glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void CWarpRenderer::drawMesh()
+{
+  gles2::CShaderProgram::use(m_program);
+  m_program.setUniform("u_mvp", glm::mat4(1.f));
+  video::setSourceUniforms(m_program, m_yuv_matrix);
+  if (m_lut_texture)
+  {
+    m_program.setUniform("u_lut", 1);
+    m_program.setUniform(
+        "u_lut_scale", static_cast<float>(m_lut->header().uv_scale));
+    gles2::CTexture2D::bind(*m_lut_texture, 1);
+  }
+  warp::setEdgeBlendUniforms(
+      m_program, m_key_points.blend, m_mask_texture.has_value());
+  if (m_mask_texture)
+  {
+    gles2::CTexture2D::bind(*m_mask_texture, warp::c_blend_mask_unit);
+  }
+  if (m_surface)
+  {
+    warp::setSurfaceUniforms(m_program, *m_surface);
+  }
+  m_mesh.draw(m_program);
+}
+
+void CWarpRenderer::readPixels(uint8_t* pixels) const
+{
+  const glm::uvec2& size = m_target.size();
+  glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+} // namespace app
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <optional>
+
+#include "Options.hpp"
+#include "gles2/CMesh.hpp"
+#include "gles2/CRenderTarget.hpp"
+#include "gles2/CShaderProgram.hpp"
+#include "gles2/CTexture2D.hpp"
+#include "video/CFrameUploader.hpp"
+#include "warp/CLutFile.hpp"
+#include "warp/CSplineSurface.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/KeyPoints.hpp"
+
+namespace app {
+
+/// Offscreen GLES2 warp of headless mode: the distortion mesh, or a quad
+/// with a baked LUT, drawn into a texture backed frame buffer. Sources are
+/// of @p source_format, YUV is converted with opts.yuv_matrix, and the edge
+/// blending of @p key_points is applied in the same pass. With
+/// opts.gpu_surface the vertex shader evaluates the surface. Needs a current
+/// context for its whole life.
+class CWarpRenderer
+{
+public:
+  explicit CWarpRenderer(
+      const Options& opts,
+      const warp::KeyPoints& key_points,
+      const warp::CLutFile* lut,
+      video::PixelFormat source_format = video::PixelFormat::Rgba);
+
+  /// Warps @p source into a target of @p size, which is only reallocated
+  /// when the size changes and stays bound for readPixels().
+  void draw(const gles2::CTexture2D& source, const glm::uvec2& size);
+  void draw(const video::CFrameUploader& source, const glm::uvec2& size);
+
+  /// RGBA rows of the last draw, bottom-up.
+  void readPixels(uint8_t* pixels) const;
+
+  /// Pixel error of an adaptive mesh, which is tessellated again for every
+  /// new target size.
+  float meshError() const { return m_mesh_error; }
+
+private:
+  void bindTarget(const glm::uvec2& size);
+  void drawMesh();
+
+  const warp::CLutFile* m_lut;
+  video::YuvMatrix m_yuv_matrix;
+  warp::KeyPoints m_key_points;
+  warp::MeshDensity m_density;
+  float m_mesh_error;
+  std::optional<warp::CSplineSurface> m_surface;
+  gles2::CMesh m_mesh;
+  gles2::CShaderProgram m_program;
+  std::optional<gles2::CTexture2D> m_lut_texture;
+  std::optional<gles2::CTexture2D> m_mask_texture;
+  gles2::CRenderTarget m_target;
+};
+
+} // namespace app
@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "ExportLut.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+#include "warp/CLutFile.hpp"
+#include "warp/CUvMap.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/KeyPoints.hpp"
+
+namespace app {
+
+int runExportLut(const Options& opts)
+{
+  const warp::KeyPoints key_points =
+      opts.kps_path.empty() ? warp::makeDefaultKeyPoints(opts.grid_size)
+                            : warp::loadKeyPoints(opts.kps_path);
+
+  gles2::CMesh::Vertices vertices;
+  gles2::CMesh::Indices indices;
+  float mesh_error = 0.f;
+  warp::generateDistortionGrid(
+      {opts.num_points, opts.tolerance, opts.output_size},
+      key_points,
+      vertices,
+      indices,
+      &mesh_error);
+  const warp::CUvMap uv_map(vertices, indices, opts.output_size);
+  warp::exportLut(uv_map, opts.export_lut_path);
+
+  std::cout << "Exported " << opts.output_size.x << "x" << opts.output_size.y
+            << " LUT to " << opts.export_lut_path;
+  if (opts.tolerance > 0.f)
+  {
+    std::cout << " (mesh error " << mesh_error << " px)";
+  }
+  std::cout << std::endl;
+  return EXIT_SUCCESS;
+}
+
+} // namespace app
@@ -0,0 +1,328 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "Headless.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "CTestPattern.hpp"
+#include "CWarpRenderer.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CFrameBuffer.hpp"
+#include "gles2/CRenderTarget.hpp"
+#include "gles2/CStateCache.hpp"
+#include "gles2/CTexture2D.hpp"
+#include "video/CFrameReader.hpp"
+#include "video/CFrameUploader.hpp"
+#include "video/CVideoStream.hpp"
+#include "warp/CCpuWarp.hpp"
+#include "warp/CLutFile.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/Image.hpp"
+#include "warp/KeyPoints.hpp"
+
+namespace app {
+
+namespace {
+
+std::filesystem::path outputPath(
+    const std::filesystem::path& output_dir,
+    const std::string& input)
+{
+  return output_dir / std::filesystem::path(input).stem().concat(".png");
+}
+
+int warpWithGles2(
+    const Options& opts,
+    const warp::KeyPoints& key_points,
+    const warp::CLutFile* lut,
+    const std::filesystem::path& output_dir)
+{
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+
+  std::size_t num_failed = 0;
+  {
+    CWarpRenderer renderer(opts, key_points, lut);
+
+    if (opts.pattern_size.x)
+    {
+      CTestPattern pattern;
+      gles2::CRenderTarget source;
+      pattern.render(source, opts.pattern_size);
+
+      const glm::uvec2 size = lut                 ? lut->size()
+                              : opts.output_size.x ? opts.output_size
+                                                   : opts.pattern_size;
+      renderer.draw(source.texture(), size);
+      warp::Image warped{size, 4, {}};
+      warped.pixels.resize(size.x * size.y * warped.channels);
+      renderer.readPixels(warped.pixels.data());
+      gles2::CFrameBuffer::unbind();
+
+      const auto output = output_dir / "pattern.png";
+      warp::saveImage(warped, output.string());
+      std::cout << "pattern -> " << output.string() << std::endl;
+    }
+
+    for (auto&& path : opts.image_paths)
+    {
+      try
+      {
+        gles2::CTexture2D image = gles2::CTexture2D::load(path, opts.mipmaps);
+        const glm::uvec2 size = lut                 ? lut->size()
+                                : opts.output_size.x ? opts.output_size
+                                                     : image.imageSize();
+
+        renderer.draw(image, size);
+
+        warp::Image warped{size, 4, {}};
+        warped.pixels.resize(size.x * size.y * warped.channels);
+        renderer.readPixels(warped.pixels.data());
+        gles2::CFrameBuffer::unbind();
+
+        const auto output = outputPath(output_dir, path);
+        warp::saveImage(warped, output.string());
+        std::cout << path << " -> " << output.string();
+        if (opts.tolerance > 0.f)
+        {
+          std::cout << " (mesh error " << renderer.meshError() << " px)";
+        }
+        std::cout << std::endl;
+      }
+      catch (const std::runtime_error& e)
+      {
+        std::cerr << "Failed to warp " << path << ": " << e.what()
+                  << std::endl;
+        ++num_failed;
+      }
+    }
+
+    const auto& counters = gles2::CStateCache::current().counters();
+    std::cout << "GL state changes: " << counters.issued << " issued, "
+              << counters.elided << " elided" << std::endl;
+  }
+  egl::CContext::release(context);
+
+  return (0 == num_failed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Warped frames go out as raw top-down RGBA, so they can be piped into an
+// encoder; stdout then carries the frames and the log goes to stderr
+int warpStreamWithGles2(
+    const Options& opts,
+    const warp::KeyPoints& key_points,
+    const warp::CLutFile* lut)
+{
+  const bool to_stdout = opts.stream_output_path == "-";
+  std::ostream& log = to_stdout ? std::cerr : std::cout;
+
+  std::unique_ptr<std::FILE, int (*)(std::FILE*)> output(nullptr, &std::fclose);
+  if (to_stdout)
+  {
+    output = {stdout, [](std::FILE*) { return 0; }};
+  }
+  else if (!opts.stream_output_path.empty())
+  {
+    output.reset(std::fopen(opts.stream_output_path.c_str(), "wb"));
+    if (!output)
+    {
+      throw video::StreamError("couldn't open " + opts.stream_output_path);
+    }
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  log << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+
+  video::CVideoStream stream(
+      video::CFrameReader(
+          opts.stream_path,
+          opts.stream_size,
+          opts.stream_fps,
+          opts.stream_format),
+      false);
+  const glm::uvec2 size = lut                 ? lut->size()
+                          : opts.output_size.x ? opts.output_size
+                                               : stream.format().size;
+  {
+    CWarpRenderer renderer(
+        opts, key_points, lut, stream.format().pixel_format);
+    video::CFrameUploader uploader(stream.format());
+    std::vector<uint8_t> pixels(std::size_t{size.x} * size.y * 4);
+
+    std::size_t num_frames = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (const video::Frame* frame = stream.acquire(false, true))
+    {
+      uploader.upload(*frame);
+      stream.release();
+      renderer.draw(uploader, size);
+
+      if (output)
+      {
+        renderer.readPixels(pixels.data());
+        const std::size_t stride = std::size_t{size.x} * 4;
+        for (std::size_t y = size.y; y-- > 0;)
+        {
+          std::fwrite(&pixels[y * stride], 1, stride, output.get());
+        }
+      }
+      else
+      {
+        glFinish();
+      }
+      ++num_frames;
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    const auto stats = stream.stats();
+    log << "Stream: " << num_frames << " frames in " << elapsed.count()
+        << " s (" << num_frames / elapsed.count() << " fps), "
+        << stats.dropped << " dropped, queue depth " << stats.mean_depth
+        << " mean " << stats.max_depth << " max, decoder waited "
+        << stats.producer_wait.count() << " s" << std::endl;
+  }
+  egl::CContext::release(context);
+
+  return EXIT_SUCCESS;
+}
+
+int warpWithCpu(
+    const Options& opts,
+    const warp::KeyPoints& key_points,
+    const warp::CLutFile* lut,
+    const std::filesystem::path& output_dir)
+{
+  std::optional<warp::CCpuWarp> engine;
+  if (lut)
+  {
+    engine.emplace(lut->toUvMap(), opts.num_threads);
+  }
+  if (key_points.blend.active())
+  {
+    std::cerr << "The cpu engine ignores edge blending." << std::endl;
+  }
+  warp::Image warped{{0u, 0u}, 4, {}};
+
+  std::size_t num_failed = 0;
+  double num_pixels = 0.;
+  std::chrono::duration<double> remap_time{0.};
+  float mesh_error = 0.f;
+
+  for (auto&& path : opts.image_paths)
+  {
+    try
+    {
+      const warp::Image image = warp::loadImage(path);
+      const glm::uvec2 size = lut                 ? lut->size()
+                              : opts.output_size.x ? opts.output_size
+                                                   : image.size;
+
+      if (!engine || engine->size() != size)
+      {
+        gles2::CMesh::Vertices vertices;
+        gles2::CMesh::Indices indices;
+        warp::generateDistortionGrid(
+            {opts.num_points, opts.tolerance, size},
+            key_points,
+            vertices,
+            indices,
+            &mesh_error);
+        engine.emplace(warp::CUvMap(vertices, indices, size), opts.num_threads);
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      engine->apply(image, warped);
+      remap_time += std::chrono::steady_clock::now() - start;
+      num_pixels += static_cast<double>(size.x) * size.y;
+
+      const auto output = outputPath(output_dir, path);
+      warp::saveImage(warped, output.string());
+      std::cout << path << " -> " << output.string();
+      if (opts.tolerance > 0.f)
+      {
+        std::cout << " (mesh error " << mesh_error << " px)";
+      }
+      std::cout << std::endl;
+    }
+    catch (const std::runtime_error& e)
+    {
+      std::cerr << "Failed to warp " << path << ": " << e.what() << std::endl;
+      ++num_failed;
+    }
+  }
+
+  if (engine && remap_time.count() > 0.)
+  {
+    const double mpix_per_sec = num_pixels / remap_time.count() * 1e-6;
+    std::cout << "CPU warp (" << warp::remapRowName(engine->remapRow())
+              << ", " << engine->numThreads() << " threads): " << mpix_per_sec
+              << " MP/s, " << mpix_per_sec / engine->numThreads()
+              << " MP/s per core" << std::endl;
+  }
+
+  return (0 == num_failed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace
+
+int runHeadless(const Options& opts)
+{
+  const std::filesystem::path output_dir(opts.output_dir);
+  std::filesystem::create_directories(output_dir);
+
+  std::optional<warp::CLutFile> lut;
+  warp::KeyPoints key_points;
+  if (opts.lut_path.empty())
+  {
+    key_points = warp::loadKeyPoints(opts.kps_path);
+  }
+  else
+  {
+    lut.emplace(opts.lut_path);
+  }
+
+  const warp::CLutFile* baked = lut ? &*lut : nullptr;
+  if (!opts.stream_path.empty())
+  {
+    return warpStreamWithGles2(opts, key_points, baked);
+  }
+  if (opts.engine == Options::Engine::Cpu)
+  {
+    return warpWithCpu(opts, key_points, baked, output_dir);
+  }
+  return warpWithGles2(opts, key_points, baked, output_dir);
+}
+
+} // namespace app
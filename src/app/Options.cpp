@@ -0,0 +1,440 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "Options.hpp"
+
+#include <cstdio>
+#include <exception>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace app {
+
+namespace {
+
+glm::uvec2 parseSize(const std::string& value)
+{
+  unsigned width = 0;
+  unsigned height = 0;
+  char sep = 0;
+  if (std::sscanf(value.c_str(), "%u%c%u", &width, &sep, &height) != 3 ||
+      sep != 'x' || 0 == width || 0 == height)
+  {
+    throw OptionsError("invalid size '" + value + "', expected WxH");
+  }
+  return {width, height};
+}
+
+std::size_t parseCount(const std::string& value, bool allow_zero = false)
+{
+  std::size_t pos = 0;
+  unsigned long count = 0;
+  try
+  {
+    count = std::stoul(value, &pos);
+  }
+  catch (const std::exception&)
+  {
+    pos = 0;
+  }
+  if (pos != value.size() || (0 == count && !allow_zero))
+  {
+    throw OptionsError("invalid number '" + value + "'");
+  }
+  return count;
+}
+
+float parsePixels(const std::string& value)
+{
+  std::size_t pos = 0;
+  float pixels = 0.f;
+  try
+  {
+    pixels = std::stof(value, &pos);
+  }
+  catch (const std::exception&)
+  {
+    pos = 0;
+  }
+  if (pos != value.size() || !(pixels > 0.f))
+  {
+    throw OptionsError("invalid pixel distance '" + value + "'");
+  }
+  return pixels;
+}
+
+} // namespace
+
+Options parseOptions(int argc, const char** argv)
+{
+  Options opts;
+  std::vector<std::string> positional;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string_view arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc)
+      {
+        throw OptionsError("missing value for " + std::string(arg));
+      }
+      return argv[++i];
+    };
+
+    if (arg == "--headless")
+    {
+      opts.mode = Options::Mode::Headless;
+    }
+    else if (arg == "--engine")
+    {
+      const std::string engine = value();
+      if (engine == "gles2")
+      {
+        opts.engine = Options::Engine::Gles2;
+      }
+      else if (engine == "cpu")
+      {
+        opts.engine = Options::Engine::Cpu;
+      }
+      else
+      {
+        throw OptionsError("unknown engine '" + engine + "'");
+      }
+    }
+    else if (arg == "--redraw")
+    {
+      const std::string redraw = value();
+      if (redraw == "continuous")
+      {
+        opts.redraw = Options::Redraw::Continuous;
+      }
+      else if (redraw == "on-demand")
+      {
+        opts.redraw = Options::Redraw::OnDemand;
+      }
+      else
+      {
+        throw OptionsError("unknown redraw mode '" + redraw + "'");
+      }
+    }
+    else if (arg == "--max-fps")
+    {
+      opts.max_fps = static_cast<double>(parseCount(value()));
+    }
+    else if (arg == "--swap-interval")
+    {
+      opts.swap_interval = static_cast<int>(parseCount(value(), true));
+    }
+    else if (arg == "--threads")
+    {
+      opts.num_threads = parseCount(value());
+    }
+    else if (arg == "--add-output")
+    {
+      opts.output_kps_paths.push_back(value());
+    }
+    else if (arg == "--lut")
+    {
+      opts.lut_path = value();
+    }
+    else if (arg == "--kps")
+    {
+      opts.kps_path = value();
+    }
+    else if (arg == "--export-lut")
+    {
+      opts.mode = Options::Mode::ExportLut;
+      opts.export_lut_path = value();
+    }
+    else if (arg == "--texture-budget")
+    {
+      opts.texture_budget = parseCount(value()) << 20;
+    }
+    else if (arg == "--mipmaps")
+    {
+      opts.mipmaps = true;
+    }
+    else if (arg == "--shader-cache")
+    {
+      opts.shader_cache_dir = value();
+    }
+    else if (arg == "--parallel-compile")
+    {
+      opts.parallel_compile = true;
+    }
+    else if (arg == "--watch")
+    {
+      opts.watch = true;
+    }
+    else if (arg == "--output")
+    {
+      opts.output_dir = value();
+    }
+    else if (arg == "--size")
+    {
+      opts.output_size = parseSize(value());
+    }
+    else if (arg == "--points")
+    {
+      opts.num_points = parseCount(value());
+    }
+    else if (arg == "--tolerance")
+    {
+      opts.tolerance = parsePixels(value());
+    }
+    else if (arg == "--gpu-surface")
+    {
+      opts.gpu_surface = true;
+    }
+    else if (arg == "--grid")
+    {
+      opts.grid_size = parseSize(value());
+      if (opts.grid_size.x < 2 || opts.grid_size.y < 2)
+      {
+        throw OptionsError("key points grid needs 2+ points per side");
+      }
+    }
+    else if (arg == "--stream")
+    {
+      opts.stream_path = value();
+    }
+    else if (arg == "--stream-size")
+    {
+      opts.stream_size = parseSize(value());
+    }
+    else if (arg == "--stream-fps")
+    {
+      opts.stream_fps = static_cast<double>(parseCount(value()));
+    }
+    else if (arg == "--stream-format")
+    {
+      const std::string format = value();
+      if (format == "rgba")
+      {
+        opts.stream_format = video::PixelFormat::Rgba;
+      }
+      else if (format == "i420")
+      {
+        opts.stream_format = video::PixelFormat::I420;
+      }
+      else if (format == "nv12")
+      {
+        opts.stream_format = video::PixelFormat::Nv12;
+      }
+      else
+      {
+        throw OptionsError("unknown stream format '" + format + "'");
+      }
+    }
+    else if (arg == "--yuv-matrix")
+    {
+      const std::string matrix = value();
+      if (matrix == "601")
+      {
+        opts.yuv_matrix = video::YuvMatrix::Bt601;
+      }
+      else if (matrix == "709")
+      {
+        opts.yuv_matrix = video::YuvMatrix::Bt709;
+      }
+      else
+      {
+        throw OptionsError("unknown YUV matrix '" + matrix + "'");
+      }
+    }
+    else if (arg == "--pattern")
+    {
+      opts.pattern_size = parseSize(value());
+    }
+    else if (arg == "--stream-output")
+    {
+      opts.stream_output_path = value();
+    }
+    else if (arg == "--profile")
+    {
+      opts.profile_path = value();
+    }
+    else if (arg.size() > 1 && arg[0] == '-')
+    {
+      throw OptionsError("unknown option " + std::string(arg));
+    }
+    else
+    {
+      positional.emplace_back(arg);
+    }
+  }
+
+  // A baked LUT replaces the key points, so every argument is an image,
+  // as it is once --kps names them
+  const bool baked = !opts.lut_path.empty();
+  if (!positional.empty())
+  {
+    if (!baked && opts.kps_path.empty())
+    {
+      opts.kps_path = positional.front();
+      positional.erase(positional.begin());
+    }
+    opts.image_paths = std::move(positional);
+  }
+
+  if (opts.pattern_size.x && !opts.stream_path.empty())
+  {
+    throw OptionsError("a pattern and a stream can't be warped together");
+  }
+  if (opts.mode != Options::Mode::Interactive &&
+      !opts.output_kps_paths.empty())
+  {
+    throw OptionsError("more outputs are supported interactively only");
+  }
+  const bool paced = opts.redraw != Options::Redraw::Continuous ||
+                     opts.max_fps > 0. || opts.swap_interval.has_value();
+  if (opts.mode != Options::Mode::Interactive &&
+      (!opts.profile_path.empty() || paced || opts.watch))
+  {
+    throw OptionsError(
+        "profiling, watching, redraw and frame rate options are interactive "
+        "only");
+  }
+  if (opts.gpu_surface &&
+      (baked || opts.tolerance > 0.f || opts.mode == Options::Mode::ExportLut ||
+       opts.engine == Options::Engine::Cpu))
+  {
+    throw OptionsError(
+        "--gpu-surface needs key points, --points and the gles2 engine");
+  }
+
+  switch (opts.mode)
+  {
+  case Options::Mode::Headless:
+    if ((!baked && opts.kps_path.empty()) ||
+        (opts.image_paths.empty() && opts.stream_path.empty() &&
+         0 == opts.pattern_size.x))
+    {
+      throw OptionsError(
+          "headless mode needs key points or a LUT and images, a stream or "
+          "a pattern");
+    }
+    if ((!opts.stream_path.empty() || opts.pattern_size.x) &&
+        opts.engine == Options::Engine::Cpu)
+    {
+      throw OptionsError(
+          "streams and patterns are warped by the gles2 engine only");
+    }
+    if (baked && opts.output_size.x)
+    {
+      throw OptionsError("output size is fixed by the LUT");
+    }
+    if (baked && !opts.kps_path.empty())
+    {
+      throw OptionsError("key points behind a LUT are edited interactively");
+    }
+    break;
+  case Options::Mode::ExportLut:
+    if (baked || 0 == opts.output_size.x)
+    {
+      throw OptionsError("LUT export needs key points and --size");
+    }
+    break;
+  case Options::Mode::Interactive:
+    if (baked && !opts.output_kps_paths.empty())
+    {
+      throw OptionsError("a baked LUT drives a single output");
+    }
+    break;
+  }
+  return opts;
+}
+
+void printUsage(std::ostream& os, const char* argv0)
+{
+  os << "Usage: " << argv0 << " [options] [key-points-file] [image...]\n"
+     << "  --headless      render offscreen and write warped images\n"
+     << "  --engine <e>    headless warp engine: gles2 (default) or cpu\n"
+     << "  --threads <n>   cpu engine worker threads (default: all cores)\n"
+     << "  --lut <file>    warp with a baked LUT instead of key points\n"
+     << "  --kps <file>    key points file, every other argument is an image "
+        "then;\n"
+     << "                  with --lut, the key points the LUT was baked "
+        "from, which\n"
+     << "                  key edits go on with\n"
+     << "  --add-output <file>\n"
+     << "                  another output next to the first one, warped "
+        "with these\n"
+     << "                  key points (repeatable, Tab selects the one to "
+        "edit)\n"
+     << "  --export-lut <file>\n"
+     << "                  bake the key points into a LUT of --size\n"
+     << "  --output <dir>  headless output directory (default: .)\n"
+     << "  --size <WxH>    headless output size (default: image size)\n"
+     << "  --points <n>    distortion mesh points per side (default: 30)\n"
+     << "  --tolerance <px>\n"
+     << "                  tessellate the mesh adaptively to this pixel "
+        "error\n"
+     << "                  instead of --points\n"
+     << "  --gpu-surface   evaluate the spline surface in the vertex shader, "
+        "key\n"
+     << "                  point edits then upload no vertices\n"
+     << "  --mipmaps       sample images trilinearly from mipmaps\n"
+     << "  --texture-budget <MiB>\n"
+     << "                  image textures kept on the GPU (default: 256)\n"
+     << "  --shader-cache <dir>\n"
+     << "                  keep linked shader programs here for faster "
+        "starts\n"
+     << "  --parallel-compile\n"
+     << "                  let the driver compile all shaders at once\n"
+     << "  --watch         apply key point files as soon as another program "
+        "has\n"
+     << "                  rewritten them\n"
+     << "  --grid <CxR>    key points grid when no file is given "
+        "(default: 4x4)\n"
+     << "  --pattern <WxH> warp a calibration pattern rendered at this size\n"
+     << "                  (headless: written as pattern.png)\n"
+     << "  --stream <file> warp a Y4M (4:2:0) stream, - reads stdin\n"
+     << "  --stream-size <WxH>\n"
+     << "                  the stream is raw frames of this size\n"
+     << "  --stream-format <f>\n"
+     << "                  raw frames: rgba (default), i420 or nv12\n"
+     << "  --yuv-matrix <m>\n"
+     << "                  YUV streams: 601 (default) or 709\n"
+     << "  --stream-fps <n>\n"
+     << "                  play a raw stream at n frames per second\n"
+     << "  --stream-output <file>\n"
+     << "                  headless: write warped raw RGBA frames, - for "
+        "stdout\n"
+     << "  --redraw <r>    continuous (default) or on-demand, which only "
+        "redraws\n"
+     << "                  when the calibration, view, source or window "
+        "changes\n"
+     << "  --max-fps <n>   cap the interactive frame rate\n"
+     << "  --swap-interval <n>\n"
+     << "                  vertical blanks per buffer swap, 0 disables "
+        "vsync\n"
+     << "  --profile <file>\n"
+     << "                  time the frame phases on the CPU and GPU, write "
+        "JSON\n"
+     << "                  percentiles on F2 and at exit\n";
+}
+
+} // namespace app
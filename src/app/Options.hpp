@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+#include <iosfwd>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "video/Frame.hpp"
+
+namespace app {
+
+struct OptionsError : std::runtime_error
+{
+  using std::runtime_error::runtime_error;
+};
+
+struct Options
+{
+  enum class Mode
+  {
+    Interactive,
+    Headless,
+    ExportLut,
+  };
+
+  enum class Engine
+  {
+    Gles2,
+    Cpu,
+  };
+
+  enum class Redraw
+  {
+    Continuous,
+    OnDemand,
+  };
+
+  Mode mode = Mode::Interactive;
+  Engine engine = Engine::Gles2;
+  Redraw redraw = Redraw::Continuous;
+  /// Interactive frame rate cap, 0 for none.
+  double max_fps = 0.;
+  /// Frames per buffer swap, the driver default when not set.
+  std::optional<int> swap_interval;
+  /// Behind the LUT when lut_path is set too, editing drops the LUT.
+  std::string kps_path;
+  /// Key points of the outputs after the first one, interactive only.
+  std::vector<std::string> output_kps_paths;
+  std::string lut_path;
+  std::string export_lut_path;
+  std::vector<std::string> image_paths;
+  std::string stream_path;
+  std::string stream_output_path;
+  glm::uvec2 stream_size{0u, 0u};
+  double stream_fps = 0.;
+  glm::uvec2 pattern_size{0u, 0u};
+  video::PixelFormat stream_format = video::PixelFormat::Rgba;
+  video::YuvMatrix yuv_matrix = video::YuvMatrix::Bt601;
+  std::string output_dir = ".";
+  /// Frame timing report written on demand and at exit, interactive only.
+  std::string profile_path;
+  glm::uvec2 output_size{0u, 0u};
+  bool mipmaps = false;
+  /// Bytes of image textures the interactive window keeps resident.
+  std::size_t texture_budget = std::size_t{256} << 20;
+  /// Linked programs are cached here, no cache when empty.
+  std::string shader_cache_dir;
+  bool parallel_compile = false;
+  /// Reload key point files rewritten by other processes, interactive only.
+  bool watch = false;
+  std::size_t num_points = 30;
+  /// Tessellate the mesh adaptively within this many pixels of the spline
+  /// surface instead of num_points, when above zero.
+  float tolerance = 0.f;
+  /// Evaluate the spline surface in the vertex shader over a static grid.
+  bool gpu_surface = false;
+  glm::uvec2 grid_size{4u, 4u};
+  std::size_t num_threads = 0;
+};
+
+Options parseOptions(int argc, const char** argv);
+void printUsage(std::ostream& os, const char* argv0);
+
+} // namespace app
@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CContext.hpp"
+
+#include <EGL/eglext.h>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace egl {
+
+namespace {
+
+bool hasExtension(const char* extensions, const char* name)
+{
+  if (nullptr == extensions)
+  {
+    return false;
+  }
+  const std::size_t len = std::strlen(name);
+  for (const char* p = extensions; (p = std::strstr(p, name)); p += len)
+  {
+    if ((p == extensions || p[-1] == ' ') && (p[len] == ' ' || p[len] == 0))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+EGLDisplay getDisplay()
+{
+  const char* client_exts = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+  if (hasExtension(client_exts, "EGL_MESA_platform_surfaceless"))
+  {
+    auto get_platform_display =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (get_platform_display)
+    {
+      EGLDisplay display = get_platform_display(
+          EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+      if (EGL_NO_DISPLAY != display)
+      {
+        return display;
+      }
+    }
+  }
+  return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+} // namespace
+
+CContext::CContext()
+  : m_display(getDisplay())
+  , m_context(EGL_NO_CONTEXT)
+  , m_surface(EGL_NO_SURFACE)
+{
+  if (EGL_NO_DISPLAY == m_display || !eglInitialize(m_display, 0, 0))
+  {
+    throw std::runtime_error("couldn't initialize EGL display");
+  }
+  eglBindAPI(EGL_OPENGL_ES_API);
+
+  const char* exts = eglQueryString(m_display, EGL_EXTENSIONS);
+  const bool surfaceless = hasExtension(exts, "EGL_KHR_surfaceless_context");
+
+  const EGLint config_attrs[] = {
+      EGL_SURFACE_TYPE,
+      surfaceless ? 0 : EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE,
+      EGL_OPENGL_ES2_BIT,
+      EGL_NONE,
+  };
+  EGLConfig config = nullptr;
+  EGLint num_configs = 0;
+  eglChooseConfig(m_display, config_attrs, &config, 1, &num_configs);
+  if (0 == num_configs)
+  {
+    if (!surfaceless || !hasExtension(exts, "EGL_KHR_no_config_context"))
+    {
+      eglTerminate(m_display);
+      throw std::runtime_error("couldn't choose EGL config");
+    }
+    config = EGL_NO_CONFIG_KHR;
+  }
+
+  const EGLint context_attrs[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+  m_context =
+      eglCreateContext(m_display, config, EGL_NO_CONTEXT, context_attrs);
+  if (EGL_NO_CONTEXT == m_context)
+  {
+    std::cerr << "eglCreateContext failed: " << std::hex << eglGetError()
+              << std::dec << std::endl;
+    eglTerminate(m_display);
+    throw std::runtime_error("couldn't create EGL context");
+  }
+
+  if (!surfaceless)
+  {
+    const EGLint pbuffer_attrs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+    m_surface = eglCreatePbufferSurface(m_display, config, pbuffer_attrs);
+    if (EGL_NO_SURFACE == m_surface)
+    {
+      eglDestroyContext(m_display, m_context);
+      eglTerminate(m_display);
+      throw std::runtime_error("couldn't create EGL pbuffer surface");
+    }
+  }
+}
+
+CContext::CContext(CContext&& rhs) noexcept
+  : m_display(std::move(rhs.m_display))
+  , m_context(std::move(rhs.m_context))
+  , m_surface(std::move(rhs.m_surface))
+{
+  rhs.m_display = EGL_NO_DISPLAY;
+  rhs.m_context = EGL_NO_CONTEXT;
+  rhs.m_surface = EGL_NO_SURFACE;
+}
+
+CContext& CContext::operator=(CContext&& rhs) noexcept
+{
+  std::swap(m_display, rhs.m_display);
+  std::swap(m_context, rhs.m_context);
+  std::swap(m_surface, rhs.m_surface);
+  return *this;
+}
+
+CContext::~CContext()
+{
+  if (EGL_NO_DISPLAY == m_display)
+  {
+    return;
+  }
+  if (eglGetCurrentContext() == m_context)
+  {
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  }
+  if (EGL_NO_SURFACE != m_surface)
+  {
+    eglDestroySurface(m_display, m_surface);
+  }
+  eglDestroyContext(m_display, m_context);
+  eglTerminate(m_display);
+}
+
+void CContext::makeCurrent(const CContext& ctx)
+{
+  if (!eglMakeCurrent(
+          ctx.m_display, ctx.m_surface, ctx.m_surface, ctx.m_context))
+  {
+    throw std::runtime_error("couldn't make EGL context current");
+  }
+}
+
+void CContext::release(const CContext& ctx)
+{
+  eglMakeCurrent(ctx.m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+} // namespace egl
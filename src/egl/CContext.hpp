@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <EGL/egl.h>
+
+namespace egl {
+
+/// Offscreen OpenGL ES 2 context which doesn't need a display server.
+///
+/// Prefers the Mesa surfaceless platform (works with llvmpipe on CPU-only
+/// machines) and falls back to the default display with a tiny pbuffer.
+class CContext
+{
+public:
+  CContext();
+  CContext(CContext&& rhs) noexcept;
+  CContext& operator=(CContext&& rhs) noexcept;
+  CContext(const CContext&) = delete;
+  CContext& operator=(CContext&) = delete;
+  ~CContext();
+
+  EGLDisplay display() const { return m_display; }
+  EGLContext context() const { return m_context; }
+
+  static void makeCurrent(const CContext& ctx);
+  static void release(const CContext& ctx);
+
+private:
+  EGLDisplay m_display;
+  EGLContext m_context;
+  EGLSurface m_surface;
+};
+
+} // namespace egl
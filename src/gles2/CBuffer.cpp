@@ -26,6 +26,9 @@
 
 #include <utility>
 
+#include "CStateCache.hpp"
+#include "CVertexArray.hpp"
+
 namespace gles2 {
 
 CBuffer::CBuffer(
@@ -37,9 +40,13 @@ CBuffer::CBuffer(
   , m_target(target)
 {
   glGenBuffers(1, &m_id);
-  glBindBuffer(m_target, m_id);
+  if (m_target == GL_ELEMENT_ARRAY_BUFFER)
+  {
+    // Don't replace the index buffer of whatever vertex array is bound
+    CVertexArray::unbind();
+  }
+  CStateCache::current().bindBuffer(m_target, m_id);
   glBufferData(m_target, size, data, usage);
-  glBindBuffer(m_target, 0);
 }
 
 CBuffer::CBuffer(CBuffer&& rhs) noexcept
@@ -59,7 +66,7 @@ CBuffer& CBuffer::operator=(CBuffer&& rhs) noexcept
 
 CBuffer::~CBuffer()
 {
-  glDeleteBuffers(1, &m_id);
+  CStateCache::current().deleteBuffer(m_id);
 }
 
 void CBuffer::update(GLintptr offset, GLsizeiptr size, const GLvoid* data)
@@ -69,12 +76,12 @@ void CBuffer::update(GLintptr offset, GLsizeiptr size, const GLvoid* data)
 
 void CBuffer::bind(const CBuffer& buf)
 {
-  glBindBuffer(buf.target(), buf.id());
+  CStateCache::current().bindBuffer(buf.target(), buf.id());
 }
 
 void CBuffer::unbind(GLenum target)
 {
-  glBindBuffer(target, 0);
+  CStateCache::current().bindBuffer(target, 0);
 }
 
 } // namespace gles2
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <utility>
 
+#include "CStateCache.hpp"
 #include "CTexture2D.hpp"
 
 namespace gles2 {
@@ -35,7 +36,7 @@ CFrameBuffer::CFrameBuffer(const CTexture2D& color)
   : m_id(0)
 {
   glGenFramebuffers(1, &m_id);
-  glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+  CStateCache::current().bindFramebuffer(m_id);
 
   glFramebufferTexture2D(
       GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color.id(), 0);
@@ -43,10 +44,10 @@ CFrameBuffer::CFrameBuffer(const CTexture2D& color)
   if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
   {
     std::cerr << "Framebuffer creation failed." << std::endl;
-    glDeleteFramebuffers(1, &m_id);
+    CStateCache::current().deleteFramebuffer(m_id);
     m_id = 0;
   }
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  CStateCache::current().bindFramebuffer(0);
 
   if (0 == m_id)
   {
@@ -69,17 +70,17 @@ CFrameBuffer& CFrameBuffer::operator=(CFrameBuffer&& rhs) noexcept
 
 CFrameBuffer::~CFrameBuffer()
 {
-  glDeleteFramebuffers(1, &m_id);
+  CStateCache::current().deleteFramebuffer(m_id);
 }
 
 void CFrameBuffer::bind(const CFrameBuffer& fb)
 {
-  glBindFramebuffer(GL_FRAMEBUFFER, fb.id());
+  CStateCache::current().bindFramebuffer(fb.id());
 }
 
 void CFrameBuffer::unbind()
 {
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  CStateCache::current().bindFramebuffer(0);
 }
 
 } // namespace gles2
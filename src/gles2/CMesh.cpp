@@ -24,60 +24,244 @@
 
 #include "CMesh.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Extensions.hpp"
+
 namespace gles2 {
 
-CMesh::CMesh(Vertices vertices, Indices indices)
-  : m_vertices(vertices)
-  , m_indices(indices)
-  , m_vbuffer(GL_ARRAY_BUFFER, vertices)
-  , m_ibuffer(GL_ELEMENT_ARRAY_BUFFER, indices)
+namespace {
+
+GLenum indexType(std::size_t num_vertices)
 {
+  if (num_vertices <= std::numeric_limits<uint16_t>::max() + std::size_t{1})
+  {
+    return GL_UNSIGNED_SHORT;
+  }
+  if (!hasExtension("GL_OES_element_index_uint"))
+  {
+    throw std::runtime_error(
+        "mesh of " + std::to_string(num_vertices) +
+        " vertices needs GL_OES_element_index_uint");
+  }
+  return GL_UNSIGNED_INT;
 }
 
-void CMesh::draw(CShaderProgram& program, bool points)
+const GLvoid* narrowIndices(
+    GLenum type,
+    const CMesh::Indices& indices,
+    std::vector<uint16_t>& short_indices)
 {
-  gles2::CBuffer::bind(m_vbuffer);
-  gles2::CBuffer::bind(m_ibuffer);
+  if (type == GL_UNSIGNED_INT)
+  {
+    return indices.data();
+  }
+  short_indices.assign(indices.begin(), indices.end());
+  return short_indices.data();
+}
 
-  program.enableAttrArray("a_pos");
-  program.enableAttrArray("a_tex0");
-  program.setAttrBuffer("a_pos", GL_FLOAT, 3, 5 * sizeof(float), 0);
-  program.setAttrBuffer(
-      "a_tex0", GL_FLOAT, 2, 5 * sizeof(float), 3 * sizeof(float));
+CBuffer makeIndexBuffer(GLenum type, const CMesh::Indices& indices)
+{
+  std::vector<uint16_t> short_indices;
+  const GLvoid* data = narrowIndices(type, indices, short_indices);
+  const std::size_t size =
+      (type == GL_UNSIGNED_INT) ? sizeof(uint32_t) : sizeof(uint16_t);
+  return CBuffer(GL_ELEMENT_ARRAY_BUFFER, size * indices.size(), data);
+}
 
-  glDrawElements(
+} // namespace
+
+CMesh::CMesh(Vertices vertices, Indices indices, GLenum vertex_usage)
+  : m_vertices(std::move(vertices))
+  , m_indices(std::move(indices))
+  , m_index_type(indexType(m_vertices.size()))
+  , m_vbuffer(GL_ARRAY_BUFFER, m_vertices, vertex_usage)
+  , m_ibuffer(makeIndexBuffer(m_index_type, m_indices))
+{
+}
+
+std::size_t CMesh::updateVertices(const Vertices& vertices)
+{
+  if (vertices.size() != m_vertices.size())
+  {
+    throw std::invalid_argument("vertex count mismatch");
+  }
+
+  // Runs closer than this go out as one upload, a call per few vertices
+  // costs more than sending the unchanged ones in between
+  constexpr std::size_t c_max_gap = 64;
+  auto same = [&](std::size_t i) {
+    return std::memcmp(&vertices[i], &m_vertices[i], sizeof(Vertex)) == 0;
+  };
+
+  const std::size_t count = vertices.size();
+  std::size_t sent = 0;
+  std::size_t begin = 0;
+  while (begin < count)
+  {
+    while (begin < count && same(begin))
+    {
+      ++begin;
+    }
+    if (begin == count)
+    {
+      break;
+    }
+    std::size_t end = begin + 1;
+    for (std::size_t i = end; i < count && i - end <= c_max_gap; ++i)
+    {
+      if (!same(i))
+      {
+        end = i + 1;
+      }
+    }
+
+    std::copy(
+        vertices.begin() + begin,
+        vertices.begin() + end,
+        m_vertices.begin() + begin);
+    if (0 == sent)
+    {
+      gles2::CBuffer::bind(m_vbuffer);
+    }
+    m_vbuffer.update(
+        sizeof(Vertex) * begin,
+        sizeof(Vertex) * (end - begin),
+        &m_vertices[begin]);
+    sent += end - begin;
+    begin = end;
+  }
+  return sent;
+}
+
+void CMesh::draw(CShaderProgram& program, bool points)
+{
+  drawElements(
+      binding(program),
+      false,
       points ? GL_POINTS : GL_TRIANGLE_STRIP,
       m_indices.size(),
-      GL_UNSIGNED_SHORT,
       nullptr);
+}
 
-  program.disableAttrArray("a_pos");
-  program.disableAttrArray("a_tex0");
+void CMesh::draw(CShaderProgram& program, const Indices& indices, bool points)
+{
+  drawElements(
+      binding(program),
+      true,
+      points ? GL_POINTS : GL_TRIANGLE_STRIP,
+      indices.size(),
+      narrowIndices(m_index_type, indices, m_short_indices));
+}
 
-  gles2::CBuffer::unbind(GL_ARRAY_BUFFER);
-  gles2::CBuffer::unbind(GL_ELEMENT_ARRAY_BUFFER);
+CMesh::Binding& CMesh::binding(const CShaderProgram& program)
+{
+  // Programs are few, a linear search beats anything fancier
+  for (auto&& binding : m_bindings)
+  {
+    if (binding.program == program.serial())
+    {
+      return binding;
+    }
+  }
+  m_bindings.push_back(
+      {program.serial(),
+       program.attribLocation("a_pos"),
+       program.attribLocation("a_tex0"),
+       std::nullopt,
+       std::nullopt});
+  return m_bindings.back();
 }
 
-void CMesh::draw(CShaderProgram& program, const Indices& indices, bool points)
+void CMesh::enableAttribs(const Binding& binding) const
 {
-  gles2::CBuffer::bind(m_vbuffer);
+  if (binding.pos_location > -1)
+  {
+    glEnableVertexAttribArray(binding.pos_location);
+    glVertexAttribPointer(
+        binding.pos_location,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Vertex),
+        reinterpret_cast<const GLvoid*>(offsetof(Vertex, position)));
+  }
+  if (binding.tex0_location > -1)
+  {
+    glEnableVertexAttribArray(binding.tex0_location);
+    glVertexAttribPointer(
+        binding.tex0_location,
+        2,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Vertex),
+        reinterpret_cast<const GLvoid*>(offsetof(Vertex, text0)));
+  }
+}
 
-  program.enableAttrArray("a_pos");
-  program.enableAttrArray("a_tex0");
-  program.setAttrBuffer("a_pos", GL_FLOAT, 3, 5 * sizeof(float), 0);
-  program.setAttrBuffer(
-      "a_tex0", GL_FLOAT, 2, 5 * sizeof(float), 3 * sizeof(float));
+void CMesh::disableAttribs(const Binding& binding) const
+{
+  if (binding.pos_location > -1)
+  {
+    glDisableVertexAttribArray(binding.pos_location);
+  }
+  if (binding.tex0_location > -1)
+  {
+    glDisableVertexAttribArray(binding.tex0_location);
+  }
+}
 
-  glDrawElements(
-      points ? GL_POINTS : GL_TRIANGLE_STRIP,
-      indices.size(),
-      GL_UNSIGNED_SHORT,
-      indices.data());
+void CMesh::drawElements(
+    Binding& binding,
+    bool client_indices,
+    GLenum mode,
+    GLsizei count,
+    const GLvoid* indices)
+{
+  if (CVertexArray::supported())
+  {
+    // Client side indices need a vertex array without the index buffer
+    auto& vao = client_indices ? binding.client_vao : binding.vao;
+    if (!vao)
+    {
+      vao.emplace();
+      CVertexArray::bind(*vao);
+      gles2::CBuffer::bind(m_vbuffer);
+      if (!client_indices)
+      {
+        gles2::CBuffer::bind(m_ibuffer);
+      }
+      enableAttribs(binding);
+    }
+    else
+    {
+      CVertexArray::bind(*vao);
+    }
+
+    glDrawElements(mode, count, m_index_type, indices);
+    return;
+  }
+
+  gles2::CBuffer::bind(m_vbuffer);
+  if (client_indices)
+  {
+    gles2::CBuffer::unbind(GL_ELEMENT_ARRAY_BUFFER);
+  }
+  else
+  {
+    gles2::CBuffer::bind(m_ibuffer);
+  }
+  enableAttribs(binding);
 
-  program.disableAttrArray("a_pos");
-  program.disableAttrArray("a_tex0");
+  glDrawElements(mode, count, m_index_type, indices);
 
-  gles2::CBuffer::unbind(GL_ARRAY_BUFFER);
+  disableAttribs(binding);
 }
 
 } // namespace gles2
@@ -25,12 +25,15 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <optional>
 #include <vector>
 
 #include "CBuffer.hpp"
 #include "CShaderProgram.hpp"
+#include "CVertexArray.hpp"
 
 namespace gles2 {
 
@@ -44,25 +47,61 @@ public:
   };
 
   using Vertices = std::vector<Vertex>;
-  using Indices = std::vector<uint16_t>;
+  using Indices = std::vector<uint32_t>;
 
 public:
-  explicit CMesh(Vertices vertices, Indices indices);
+  /// Indices are sent to GL as GL_UNSIGNED_SHORT while every vertex can be
+  /// addressed by one, bigger meshes need OES_element_index_uint.
+  explicit CMesh(
+      Vertices vertices,
+      Indices indices,
+      GLenum vertex_usage = GL_STATIC_DRAW);
 
   const Vertices& getVertices() const { return m_vertices; }
   const Indices& getIndices() const { return m_indices; }
 
   const gles2::CBuffer& getIBuffer() const { return m_ibuffer; }
   const gles2::CBuffer& getVBuffer() const { return m_vbuffer; }
+  GLenum getIndexType() const { return m_index_type; }
 
+  /// Replaces the vertices in place, the index buffer is left untouched.
+  /// Only the runs of vertices which actually differ are sent to GL, the
+  /// vertex count must stay the same. Returns the number of vertices sent.
+  std::size_t updateVertices(const Vertices& vertices);
+
+  /// The attribute setup is recorded once per program, in a vertex array
+  /// object when OES_vertex_array_object is there.
   void draw(CShaderProgram& prg, bool points = false);
   void draw(CShaderProgram& prg, const Indices& indices, bool points = false);
 
 private:
+  struct Binding
+  {
+    /// CShaderProgram::serial(), program names get reused.
+    uint64_t program;
+    GLint pos_location;
+    GLint tex0_location;
+    std::optional<CVertexArray> vao;
+    std::optional<CVertexArray> client_vao;
+  };
+
+  Binding& binding(const CShaderProgram& prg);
+  void enableAttribs(const Binding& binding) const;
+  void disableAttribs(const Binding& binding) const;
+  void drawElements(
+      Binding& binding,
+      bool client_indices,
+      GLenum mode,
+      GLsizei count,
+      const GLvoid* indices);
+
   Vertices m_vertices;
   Indices m_indices;
+  GLenum m_index_type;
+  std::vector<uint16_t> m_short_indices;
   gles2::CBuffer m_vbuffer;
   gles2::CBuffer m_ibuffer;
+  std::vector<Binding> m_bindings;
 };
 
 } // namespace gles2
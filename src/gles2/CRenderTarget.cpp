@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CRenderTarget.hpp"
+
+namespace gles2 {
+
+bool CRenderTarget::resize(const glm::uvec2 &size)
+{
+  if (m_texture && m_texture->size() == size)
+  {
+    return false;
+  }
+
+  m_frame_buffer.reset();
+  m_texture.emplace(size, GL_RGBA);
+  m_frame_buffer.emplace(*m_texture);
+  return true;
+}
+
+void CRenderTarget::bind(const CRenderTarget &target)
+{
+  CFrameBuffer::bind(*target.m_frame_buffer);
+  glViewport(0, 0, target.size().x, target.size().y);
+}
+
+} // namespace gles2
@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <optional>
+
+#include "CFrameBuffer.hpp"
+#include "CTexture2D.hpp"
+
+namespace gles2 {
+
+/// RGBA texture with a frame buffer to render into it, so drawn content
+/// can be sampled like an image. Both are kept across frames and only
+/// reallocated when the size changes.
+class CRenderTarget
+{
+public:
+  /// Returns whether the texture had to be reallocated, which leaves its
+  /// content undefined.
+  bool resize(const glm::uvec2 &size);
+
+  bool empty() const { return !m_texture; }
+  const CTexture2D &texture() const { return *m_texture; }
+  const glm::uvec2 &size() const { return m_texture->size(); }
+
+  /// Binds the frame buffer with a viewport over the whole target.
+  static void bind(const CRenderTarget &target);
+
+private:
+  std::optional<CTexture2D> m_texture;
+  std::optional<CFrameBuffer> m_frame_buffer;
+};
+
+} // namespace gles2
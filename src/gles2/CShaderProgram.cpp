@@ -30,77 +30,180 @@
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 
+#include "CStateCache.hpp"
+#include "ProgramCache.hpp"
+
 namespace gles2 {
 
+namespace {
+
+std::atomic<uint64_t> s_next_serial{1};
+
+template <typename Infos>
+auto findByName(Infos& infos, const std::string_view& name)
+{
+  auto it = std::lower_bound(
+      infos.begin(), infos.end(), name, [](auto&& info, auto&& name) {
+        return std::string_view(info.name) < name;
+      });
+  return (it != infos.end() && it->name == name) ? it : infos.end();
+}
+
+} // namespace
+
 CShaderProgram::CShaderProgram(
     const uint8_t* vert_source,
     std::size_t vert_source_len,
     const uint8_t* frag_source,
     std::size_t frag_source_len)
-  : m_id(glCreateProgram())
+  : CShaderProgram(start(
+        {reinterpret_cast<const char*>(vert_source), vert_source_len},
+        {reinterpret_cast<const char*>(frag_source), frag_source_len}))
 {
-  GLuint vert = createShader(GL_VERTEX_SHADER, vert_source, vert_source_len);
-  GLuint frag = createShader(GL_FRAGMENT_SHADER, frag_source, frag_source_len);
+}
+
+CShaderProgram::CShaderProgram(const Pending& pending)
+  : m_id(pending.program)
+  , m_serial(s_next_serial++)
+{
+  GLint success = GL_TRUE;
+  if (pending.vert)
+  {
+    glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+  }
+  if (!success)
+  {
+    // A shader which failed to compile explains the link error best
+    if (compiled(pending.vert) && compiled(pending.frag))
+    {
+      GLint info_log_len = 0;
+      glGetProgramiv(m_id, GL_INFO_LOG_LENGTH, &info_log_len);
+      std::unique_ptr<GLchar[]> info_log(new GLchar[info_log_len]);
+      glGetProgramInfoLog(m_id, info_log_len, nullptr, info_log.get());
+      std::cerr << "Program linking error:\n" << info_log.get() << std::endl;
+    }
+    discard(pending);
+    throw std::runtime_error("couldn't create shader program");
+  }
 
-  glAttachShader(m_id, vert);
-  glAttachShader(m_id, frag);
-  glLinkProgram(m_id);
+  glDeleteShader(pending.vert);
+  glDeleteShader(pending.frag);
+  if (pending.vert && programCacheEnabled())
+  {
+    storeProgramBinary(m_id, pending.cache_key);
+  }
+  reflect();
+}
 
-  glDeleteShader(vert);
-  glDeleteShader(frag);
+std::vector<CShaderProgram> CShaderProgram::build(
+    const std::vector<Sources>& sources,
+    bool parallel)
+{
+  std::vector<CShaderProgram> programs;
+  if (!parallel)
+  {
+    for (auto&& program : sources)
+    {
+      programs.emplace_back(program.vert, program.frag);
+    }
+    return programs;
+  }
 
-  GLint success;
-  glGetProgramiv(m_id, GL_LINK_STATUS, &success);
-  if (!success)
+  std::vector<Pending> pending;
+  for (auto&& program : sources)
   {
-    GLint info_log_len = 0;
-    glGetProgramiv(m_id, GL_INFO_LOG_LENGTH, &info_log_len);
-    std::unique_ptr<GLchar[]> info_log(new GLchar[info_log_len]);
-    glGetProgramInfoLog(m_id, info_log_len, nullptr, info_log.get());
-    std::cerr << "Program linking error:\n" << info_log.get() << std::endl;
-    glDeleteProgram(m_id);
-    m_id = 0;
+    pending.push_back(start(program.vert, program.frag));
   }
 
-  if (0 == m_id)
+  for (std::size_t i = 0; i < pending.size(); ++i)
   {
-    throw std::runtime_error("couldn't create shader program");
+    try
+    {
+      programs.push_back(CShaderProgram(pending[i]));
+    }
+    catch (const std::runtime_error&)
+    {
+      for (std::size_t j = i + 1; j < pending.size(); ++j)
+      {
+        discard(pending[j]);
+      }
+      throw;
+    }
   }
+  return programs;
 }
 
 CShaderProgram::CShaderProgram(CShaderProgram&& rhs) noexcept
   : m_id(std::move(rhs.m_id))
+  , m_serial(rhs.m_serial)
+  , m_uniforms(std::move(rhs.m_uniforms))
+  , m_attribs(std::move(rhs.m_attribs))
 {
   rhs.m_id = 0u;
+  rhs.m_serial = 0u;
 }
 
 CShaderProgram& CShaderProgram::operator=(CShaderProgram&& rhs) noexcept
 {
   std::swap(m_id, rhs.m_id);
+  std::swap(m_serial, rhs.m_serial);
+  std::swap(m_uniforms, rhs.m_uniforms);
+  std::swap(m_attribs, rhs.m_attribs);
   rhs.m_id = 0u;
   return *this;
 }
 
 CShaderProgram::~CShaderProgram()
 {
-  glDeleteProgram(m_id);
+  CStateCache::current().deleteProgram(m_id);
+}
+
+CShaderProgram::Pending CShaderProgram::start(
+    const std::string_view& vert_source,
+    const std::string_view& frag_source)
+{
+  Pending pending{glCreateProgram(), 0, 0, {}};
+  if (programCacheEnabled())
+  {
+    pending.cache_key = programCacheKey(vert_source, frag_source);
+    if (loadProgramBinary(pending.program, pending.cache_key))
+    {
+      return pending;
+    }
+  }
+
+  auto compile = [&pending](GLenum type, const std::string_view& source) {
+    GLuint shader = glCreateShader(type);
+    const GLchar* src = source.data();
+    GLint src_len = static_cast<GLint>(source.size());
+    glShaderSource(shader, 1, &src, &src_len);
+    glCompileShader(shader);
+    glAttachShader(pending.program, shader);
+    return shader;
+  };
+  pending.vert = compile(GL_VERTEX_SHADER, vert_source);
+  pending.frag = compile(GL_FRAGMENT_SHADER, frag_source);
+  glLinkProgram(pending.program);
+  return pending;
 }
 
-GLuint CShaderProgram::createShader(
-    GLenum type,
-    const uint8_t* source,
-    std::size_t source_len)
+void CShaderProgram::discard(const Pending& pending)
 {
-  GLuint shader = glCreateShader(type);
-  const GLchar* src = reinterpret_cast<const GLchar*>(source);
-  GLint src_len = static_cast<GLint>(source_len);
-  glShaderSource(shader, 1, &src, &src_len);
-  glCompileShader(shader);
+  glDeleteShader(pending.vert);
+  glDeleteShader(pending.frag);
+  glDeleteProgram(pending.program);
+}
 
+bool CShaderProgram::compiled(GLuint shader)
+{
   GLint success;
   glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
   if (!success)
@@ -110,82 +213,255 @@ GLuint CShaderProgram::createShader(
     std::unique_ptr<GLchar[]> info_log(new GLchar[info_log_len]);
     glGetShaderInfoLog(shader, info_log_len, nullptr, info_log.get());
     std::cerr << "Shader compilation error:\n" << info_log.get() << std::endl;
-    glDeleteShader(shader);
-    shader = 0;
+  }
+  return success;
+}
+
+void CShaderProgram::reflect()
+{
+  GLint max_len = 0;
+  glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_len);
+  GLint attr_max_len = 0;
+  glGetProgramiv(m_id, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &attr_max_len);
+  std::string name(std::max(max_len, attr_max_len) + 1, '\0');
+
+  // Arrays are reported as "name[0]", look them up by their plain name
+  auto readName = [&name](GLsizei len) {
+    std::string result = name.substr(0, len);
+    if (auto pos = result.find('['); pos != std::string::npos)
+    {
+      result.resize(pos);
+    }
+    return result;
+  };
+
+  GLint num_uniforms = 0;
+  glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &num_uniforms);
+  for (GLint i = 0; i < num_uniforms; ++i)
+  {
+    GLsizei len = 0;
+    GLint size = 0;
+    GLenum type = GL_NONE;
+    glGetActiveUniform(m_id, i, name.size(), &len, &size, &type, &name[0]);
+    const GLint location = glGetUniformLocation(m_id, name.c_str());
+    m_uniforms.push_back({readName(len), location, type, false, {}, false});
+  }
+
+  GLint num_attribs = 0;
+  glGetProgramiv(m_id, GL_ACTIVE_ATTRIBUTES, &num_attribs);
+  for (GLint i = 0; i < num_attribs; ++i)
+  {
+    GLsizei len = 0;
+    GLint size = 0;
+    GLenum type = GL_NONE;
+    glGetActiveAttrib(m_id, i, name.size(), &len, &size, &type, &name[0]);
+    const GLint location = glGetAttribLocation(m_id, name.c_str());
+    m_attribs.push_back({readName(len), location});
   }
 
-  return shader;
+  auto byName = [](auto&& lhs, auto&& rhs) { return lhs.name < rhs.name; };
+  std::sort(m_uniforms.begin(), m_uniforms.end(), byName);
+  std::sort(m_attribs.begin(), m_attribs.end(), byName);
 }
 
-void CShaderProgram::setUniform(const std::string_view& name, float value)
+std::size_t CShaderProgram::findUniform(
+    const std::string_view& name,
+    std::initializer_list<GLenum> types) const
 {
-  if (GLint index = glGetUniformLocation(m_id, name.data()); index > -1)
+  auto it = findByName(m_uniforms, name);
+  if (it == m_uniforms.end())
+  {
+    return Uniform<float>::c_inactive;
+  }
+  if (std::find(types.begin(), types.end(), it->type) == types.end())
   {
-    glUniform1f(index, value);
+    // Like GL, which ignores a mismatching glUniform*() call, the uniform
+    // stays as it is, a render loop shouldn't die for it
+    if (!it->reported)
+    {
+      it->reported = true;
+      std::cerr << "Uniform " << name << " has another type, not set."
+                << std::endl;
+    }
+    return Uniform<float>::c_inactive;
   }
+  return it - m_uniforms.begin();
 }
 
-void CShaderProgram::setUniform(const std::string_view& name, GLint value)
+GLint CShaderProgram::uniformLocation(const std::string_view& name) const
+{
+  auto it = findByName(m_uniforms, name);
+  return (it != m_uniforms.end()) ? it->location : -1;
+}
+
+GLint CShaderProgram::attribLocation(const std::string_view& name) const
+{
+  auto it = findByName(m_attribs, name);
+  return (it != m_attribs.end()) ? it->location : -1;
+}
+
+CShaderProgram::UniformInfo* CShaderProgram::changedUniform(
+    std::size_t slot,
+    const void* value,
+    std::size_t size)
+{
+  if (slot >= m_uniforms.size())
+  {
+    return nullptr;
+  }
+  UniformInfo& info = m_uniforms[slot];
+  if (info.shadowed && std::memcmp(info.shadow.data(), value, size) == 0)
+  {
+    return nullptr;
+  }
+  return &info;
+}
+
+void CShaderProgram::shadowUniform(
+    UniformInfo& info,
+    const void* value,
+    std::size_t size)
+{
+  std::memcpy(info.shadow.data(), value, size);
+  info.shadowed = true;
+}
+
+void CShaderProgram::setUniform(Uniform<float> uniform, float value)
 {
-  if (GLint index = glGetUniformLocation(m_id, name.data()); index > -1)
+  if (auto info = changedUniform(uniform.slot, &value, sizeof(value)))
   {
-    glUniform1i(index, value);
+    glUniform1f(info->location, value);
+    shadowUniform(*info, &value, sizeof(value));
+  }
+}
+
+void CShaderProgram::setUniform(Uniform<GLint> uniform, GLint value)
+{
+  if (auto info = changedUniform(uniform.slot, &value, sizeof(value)))
+  {
+    glUniform1i(info->location, value);
+    shadowUniform(*info, &value, sizeof(value));
   }
 }
 
 void CShaderProgram::setUniform(
-    const std::string_view& name,
+    Uniform<glm::vec2> uniform,
     const glm::vec2& vec)
 {
-  if (GLint index = glGetUniformLocation(m_id, name.data()); index > -1)
+  if (auto info = changedUniform(uniform.slot, &vec, sizeof(vec)))
   {
-    glUniform2fv(index, 1, glm::value_ptr(vec));
+    glUniform2fv(info->location, 1, glm::value_ptr(vec));
+    shadowUniform(*info, &vec, sizeof(vec));
   }
 }
 
 void CShaderProgram::setUniform(
-    const std::string_view& name,
+    Uniform<glm::vec3> uniform,
     const glm::vec3& vec)
 {
-  if (GLint index = glGetUniformLocation(m_id, name.data()); index > -1)
+  if (auto info = changedUniform(uniform.slot, &vec, sizeof(vec)))
   {
-    glUniform3fv(index, 1, glm::value_ptr(vec));
+    glUniform3fv(info->location, 1, glm::value_ptr(vec));
+    shadowUniform(*info, &vec, sizeof(vec));
   }
 }
 
 void CShaderProgram::setUniform(
-    const std::string_view& name,
+    Uniform<glm::vec4> uniform,
     const glm::vec4& vec)
 {
-  if (GLint index = glGetUniformLocation(m_id, name.data()); index > -1)
+  if (auto info = changedUniform(uniform.slot, &vec, sizeof(vec)))
   {
-    glUniform4fv(index, 1, glm::value_ptr(vec));
+    glUniform4fv(info->location, 1, glm::value_ptr(vec));
+    shadowUniform(*info, &vec, sizeof(vec));
   }
 }
 
 void CShaderProgram::setUniform(
-    const std::string_view& name,
+    Uniform<glm::mat3> uniform,
     const glm::mat3& mat)
 {
-  if (GLint index = glGetUniformLocation(m_id, name.data()); index > -1)
+  if (auto info = changedUniform(uniform.slot, &mat, sizeof(mat)))
   {
-    glUniformMatrix3fv(index, 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix3fv(info->location, 1, GL_FALSE, glm::value_ptr(mat));
+    shadowUniform(*info, &mat, sizeof(mat));
   }
 }
 
 void CShaderProgram::setUniform(
-    const std::string_view& name,
+    Uniform<glm::mat4> uniform,
     const glm::mat4& mat)
 {
-  if (GLint index = glGetUniformLocation(m_id, name.data()); index > -1)
+  if (auto info = changedUniform(uniform.slot, &mat, sizeof(mat)))
+  {
+    glUniformMatrix4fv(info->location, 1, GL_FALSE, glm::value_ptr(mat));
+    shadowUniform(*info, &mat, sizeof(mat));
+  }
+}
+
+void CShaderProgram::setUniform(
+    Uniform<glm::vec4> uniform,
+    const glm::vec4* values,
+    std::size_t count)
+{
+  if (uniform.slot >= m_uniforms.size() || count == 0)
   {
-    glUniformMatrix4fv(index, 1, GL_FALSE, glm::value_ptr(mat));
+    return;
   }
+  UniformInfo& info = m_uniforms[uniform.slot];
+  info.shadowed = false;
+  glUniform4fv(
+      info.location, static_cast<GLsizei>(count), glm::value_ptr(*values));
+}
+
+void CShaderProgram::setUniform(const std::string_view& name, float value)
+{
+  setUniform(uniform<float>(name), value);
+}
+
+void CShaderProgram::setUniform(const std::string_view& name, GLint value)
+{
+  setUniform(uniform<GLint>(name), value);
+}
+
+void CShaderProgram::setUniform(
+    const std::string_view& name,
+    const glm::vec2& vec)
+{
+  setUniform(uniform<glm::vec2>(name), vec);
+}
+
+void CShaderProgram::setUniform(
+    const std::string_view& name,
+    const glm::vec3& vec)
+{
+  setUniform(uniform<glm::vec3>(name), vec);
+}
+
+void CShaderProgram::setUniform(
+    const std::string_view& name,
+    const glm::vec4& vec)
+{
+  setUniform(uniform<glm::vec4>(name), vec);
+}
+
+void CShaderProgram::setUniform(
+    const std::string_view& name,
+    const glm::mat3& mat)
+{
+  setUniform(uniform<glm::mat3>(name), mat);
+}
+
+void CShaderProgram::setUniform(
+    const std::string_view& name,
+    const glm::mat4& mat)
+{
+  setUniform(uniform<glm::mat4>(name), mat);
 }
 
 void CShaderProgram::enableAttrArray(const std::string_view& name)
 {
-  if (GLint index = glGetAttribLocation(m_id, name.data()); index > -1)
+  if (GLint index = attribLocation(name); index > -1)
   {
     glEnableVertexAttribArray(static_cast<GLuint>(index));
   }
@@ -193,7 +469,7 @@ void CShaderProgram::enableAttrArray(const std::string_view& name)
 
 void CShaderProgram::disableAttrArray(const std::string_view& name)
 {
-  if (GLint index = glGetAttribLocation(m_id, name.data()); index > -1)
+  if (GLint index = attribLocation(name); index > -1)
   {
     glDisableVertexAttribArray(static_cast<GLuint>(index));
   }
@@ -205,7 +481,7 @@ void CShaderProgram::setAttrArray(
     GLsizei stride,
     const GLfloat* values)
 {
-  if (GLint index = glGetAttribLocation(m_id, name.data()); index > -1)
+  if (GLint index = attribLocation(name); index > -1)
   {
     glVertexAttribPointer(
         static_cast<GLuint>(index),
@@ -224,7 +500,7 @@ void CShaderProgram::setAttrBuffer(
     GLsizei stride,
     GLsizeiptr offset)
 {
-  if (GLint index = glGetAttribLocation(m_id, name.data()); index > -1)
+  if (GLint index = attribLocation(name); index > -1)
   {
     glVertexAttribPointer(
         static_cast<GLuint>(index),
@@ -238,12 +514,12 @@ void CShaderProgram::setAttrBuffer(
 
 void CShaderProgram::use(const CShaderProgram& prg)
 {
-  glUseProgram(prg.id());
+  CStateCache::current().useProgram(prg.id());
 }
 
 void CShaderProgram::unuse()
 {
-  glUseProgram(0);
+  CStateCache::current().useProgram(0);
 }
 
 } // namespace gles2
@@ -25,13 +25,38 @@
 #pragma once
 
 #include <GLES2/gl2.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <glm/fwd.hpp>
+#include <initializer_list>
+#include <limits>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace gles2 {
 
 class CShaderProgram
 {
+public:
+  /// Uniform resolved once by uniform<T>(), setting it does no string work.
+  /// Handles of uniforms the linker dropped are valid and ignored.
+  template <typename T>
+  struct Uniform
+  {
+    static constexpr std::size_t c_inactive =
+        std::numeric_limits<std::size_t>::max();
+
+    std::size_t slot = c_inactive;
+  };
+
+  struct Sources
+  {
+    std::string_view vert;
+    std::string_view frag;
+  };
+
 public:
   explicit CShaderProgram(
       const uint8_t *vert_source,
@@ -50,6 +75,38 @@ public:
   ~CShaderProgram();
 
   GLuint id() const { return m_id; }
+  /// Unique per linked program for the whole process, unlike id(), which
+  /// GL hands out again once the program is deleted.
+  uint64_t serial() const { return m_serial; }
+
+  /// With @p parallel, every program starts compiling and linking before GL
+  /// is asked for any status, so the driver can build them concurrently.
+  static std::vector<CShaderProgram> build(
+      const std::vector<Sources> &sources,
+      bool parallel = true);
+
+  /// Inactive if @p name isn't, or is active with another type, which is
+  /// reported once.
+  template <typename T>
+  Uniform<T> uniform(const std::string_view &name) const;
+
+  GLint uniformLocation(const std::string_view &name) const;
+  GLint attribLocation(const std::string_view &name) const;
+
+  /// Values equal to the last ones set are not sent to GL again, the
+  /// program has to be in use otherwise.
+  void setUniform(Uniform<float> uniform, float value);
+  void setUniform(Uniform<GLint> uniform, GLint value);
+  void setUniform(Uniform<glm::vec2> uniform, const glm::vec2 &vec);
+  void setUniform(Uniform<glm::vec3> uniform, const glm::vec3 &vec);
+  void setUniform(Uniform<glm::vec4> uniform, const glm::vec4 &vec);
+  void setUniform(Uniform<glm::mat3> uniform, const glm::mat3 &mat);
+  void setUniform(Uniform<glm::mat4> uniform, const glm::mat4 &mat);
+  /// Arrays go from element 0 on and are always sent.
+  void setUniform(
+      Uniform<glm::vec4> uniform,
+      const glm::vec4 *values,
+      std::size_t count);
 
   void setUniform(const std::string_view &name, float value);
   void setUniform(const std::string_view &name, GLint value);
@@ -79,14 +136,112 @@ public:
   static void unuse();
 
 private:
-  static GLuint createShader(
-      GLenum type,
-      const uint8_t *source,
-      std::size_t source_len);
+  struct UniformInfo
+  {
+    std::string name;
+    GLint location;
+    GLenum type;
+    bool shadowed;
+    std::array<uint8_t, sizeof(GLfloat) * 16> shadow;
+    /// A type mismatch was printed already.
+    mutable bool reported;
+  };
+
+  struct AttribInfo
+  {
+    std::string name;
+    GLint location;
+  };
+
+  /// Program whose shaders were sent to GL, statuses not queried yet.
+  struct Pending
+  {
+    GLuint program;
+    GLuint vert;
+    GLuint frag;
+    std::string cache_key;
+  };
+
+  /// Links from the binary cache when possible, the shaders are 0 then.
+  static Pending start(
+      const std::string_view &vert_source,
+      const std::string_view &frag_source);
+  static void discard(const Pending &pending);
+  static bool compiled(GLuint shader);
+
+  explicit CShaderProgram(const Pending &pending);
+
+  void reflect();
+  std::size_t findUniform(
+      const std::string_view &name,
+      std::initializer_list<GLenum> types) const;
+  /// Null when @p slot is inactive or already holds @p value.
+  UniformInfo *changedUniform(
+      std::size_t slot,
+      const void *value,
+      std::size_t size);
+  /// Remembers @p value once it went to GL.
+  static void shadowUniform(
+      UniformInfo &info,
+      const void *value,
+      std::size_t size);
 
   GLuint m_id;
+  uint64_t m_serial;
+  std::vector<UniformInfo> m_uniforms;
+  std::vector<AttribInfo> m_attribs;
 };
 
+template <>
+inline CShaderProgram::Uniform<float> CShaderProgram::uniform(
+    const std::string_view &name) const
+{
+  return {findUniform(name, {GL_FLOAT})};
+}
+
+template <>
+inline CShaderProgram::Uniform<GLint> CShaderProgram::uniform(
+    const std::string_view &name) const
+{
+  return {
+      findUniform(name, {GL_INT, GL_BOOL, GL_SAMPLER_2D, GL_SAMPLER_CUBE})};
+}
+
+template <>
+inline CShaderProgram::Uniform<glm::vec2> CShaderProgram::uniform(
+    const std::string_view &name) const
+{
+  return {findUniform(name, {GL_FLOAT_VEC2})};
+}
+
+template <>
+inline CShaderProgram::Uniform<glm::vec3> CShaderProgram::uniform(
+    const std::string_view &name) const
+{
+  return {findUniform(name, {GL_FLOAT_VEC3})};
+}
+
+template <>
+inline CShaderProgram::Uniform<glm::vec4> CShaderProgram::uniform(
+    const std::string_view &name) const
+{
+  return {findUniform(name, {GL_FLOAT_VEC4})};
+}
+
+template <>
+inline CShaderProgram::Uniform<glm::mat3> CShaderProgram::uniform(
+    const std::string_view &name) const
+{
+  return {findUniform(name, {GL_FLOAT_MAT3})};
+}
+
+template <>
+inline CShaderProgram::Uniform<glm::mat4> CShaderProgram::uniform(
+    const std::string_view &name) const
+{
+  return {findUniform(name, {GL_FLOAT_MAT4})};
+}
+
 inline CShaderProgram::CShaderProgram(
     const std::string_view &vert_source,
     const std::string_view &frag_source)
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CStateCache.hpp"
+
+#include <EGL/egl.h>
+
+namespace gles2 {
+
+namespace {
+
+constexpr GLenum c_caps[] = {
+    GL_BLEND,
+    GL_CULL_FACE,
+    GL_DEPTH_TEST,
+    GL_DITHER,
+    GL_POLYGON_OFFSET_FILL,
+    GL_SAMPLE_ALPHA_TO_COVERAGE,
+    GL_SAMPLE_COVERAGE,
+    GL_SCISSOR_TEST,
+    GL_STENCIL_TEST,
+};
+
+} // namespace
+
+CStateCache::CStateCache()
+{
+  m_textures.fill(c_unknown);
+  m_caps.fill(-1);
+}
+
+CStateCache& CStateCache::current()
+{
+  thread_local CStateCache t_cache;
+
+  const void* context = eglGetCurrentContext();
+  if (t_cache.m_context != context)
+  {
+    const Counters counters = t_cache.m_counters;
+    t_cache = CStateCache();
+    t_cache.m_context = context;
+    t_cache.m_counters = counters;
+  }
+  return t_cache;
+}
+
+bool CStateCache::change(GLuint& cached, GLuint value)
+{
+  if (cached == value)
+  {
+    ++m_counters.elided;
+    return false;
+  }
+  cached = value;
+  ++m_counters.issued;
+  return true;
+}
+
+void CStateCache::bindBuffer(GLenum target, GLuint id)
+{
+  GLuint& cached =
+      (target == GL_ELEMENT_ARRAY_BUFFER) ? m_element_buffer : m_array_buffer;
+  if (change(cached, id))
+  {
+    glBindBuffer(target, id);
+  }
+}
+
+void CStateCache::bindTexture(std::size_t unit, GLuint id)
+{
+  if (unit >= c_num_units)
+  {
+    m_active_unit = c_unknown;
+    ++m_counters.issued;
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, id);
+    return;
+  }
+  // Activated even when the texture is bound already, callers go on to
+  // edit the texture through the active unit
+  if (change(m_active_unit, unit))
+  {
+    glActiveTexture(GL_TEXTURE0 + unit);
+  }
+  if (change(m_textures[unit], id))
+  {
+    glBindTexture(GL_TEXTURE_2D, id);
+  }
+}
+
+void CStateCache::useProgram(GLuint id)
+{
+  if (change(m_program, id))
+  {
+    glUseProgram(id);
+  }
+}
+
+void CStateCache::bindFramebuffer(GLuint id)
+{
+  if (change(m_framebuffer, id))
+  {
+    glBindFramebuffer(GL_FRAMEBUFFER, id);
+  }
+}
+
+void CStateCache::enable(GLenum cap)
+{
+  setCapability(cap, true);
+}
+
+void CStateCache::disable(GLenum cap)
+{
+  setCapability(cap, false);
+}
+
+void CStateCache::setCapability(GLenum cap, bool enabled)
+{
+  for (std::size_t i = 0; i < c_num_caps; ++i)
+  {
+    if (c_caps[i] == cap)
+    {
+      if (m_caps[i] == enabled)
+      {
+        ++m_counters.elided;
+        return;
+      }
+      m_caps[i] = enabled;
+      break;
+    }
+  }
+  ++m_counters.issued;
+  enabled ? glEnable(cap) : glDisable(cap);
+}
+
+bool CStateCache::changeVertexArray(GLuint id)
+{
+  if (!change(m_vertex_array, id))
+  {
+    return false;
+  }
+  // The element array buffer binding is part of the vertex array state
+  m_element_buffer = c_unknown;
+  return true;
+}
+
+void CStateCache::deleteBuffer(GLuint id)
+{
+  if (m_array_buffer == id)
+  {
+    m_array_buffer = 0;
+  }
+  if (m_element_buffer == id)
+  {
+    m_element_buffer = 0;
+  }
+  glDeleteBuffers(1, &id);
+}
+
+void CStateCache::deleteTexture(GLuint id)
+{
+  for (auto& texture : m_textures)
+  {
+    if (texture == id)
+    {
+      texture = 0;
+    }
+  }
+  glDeleteTextures(1, &id);
+}
+
+void CStateCache::deleteProgram(GLuint id)
+{
+  // A program in use stays current until another one is used
+  glDeleteProgram(id);
+}
+
+void CStateCache::deleteFramebuffer(GLuint id)
+{
+  if (m_framebuffer == id)
+  {
+    m_framebuffer = 0;
+  }
+  glDeleteFramebuffers(1, &id);
+}
+
+void CStateCache::forgetVertexArray(GLuint id)
+{
+  if (m_vertex_array == id)
+  {
+    m_vertex_array = 0;
+    m_element_buffer = c_unknown;
+  }
+}
+
+} // namespace gles2
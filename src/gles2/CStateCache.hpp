@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <GLES2/gl2.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace gles2 {
+
+/// Shadow copy of the bindings and capabilities of the context current on
+/// this thread. The gles2 wrappers change state through it, so GL is only
+/// called when something actually changes.
+class CStateCache
+{
+public:
+  struct Counters
+  {
+    std::size_t issued = 0;
+    std::size_t elided = 0;
+  };
+
+  /// Starts over with unknown state whenever another context got current.
+  static CStateCache& current();
+
+  void bindBuffer(GLenum target, GLuint id);
+  void bindTexture(std::size_t unit, GLuint id);
+  void useProgram(GLuint id);
+  void bindFramebuffer(GLuint id);
+  void enable(GLenum cap);
+  void disable(GLenum cap);
+
+  /// Vertex array objects are bound by CVertexArray, which asks here first.
+  /// Returns whether the binding changes.
+  bool changeVertexArray(GLuint id);
+
+  /// Deleting a bound object reverts its binding to 0 in GL, the shadow
+  /// state has to follow or a recycled name would be taken as bound.
+  void deleteBuffer(GLuint id);
+  void deleteTexture(GLuint id);
+  void deleteProgram(GLuint id);
+  void deleteFramebuffer(GLuint id);
+  void forgetVertexArray(GLuint id);
+
+  const Counters& counters() const { return m_counters; }
+  void resetCounters() { m_counters = {}; }
+
+private:
+  CStateCache();
+
+  static constexpr GLuint c_unknown = ~GLuint{0};
+  static constexpr std::size_t c_num_units = 8;
+  static constexpr std::size_t c_num_caps = 9;
+
+  bool change(GLuint& cached, GLuint value);
+  void setCapability(GLenum cap, bool enabled);
+
+  const void* m_context = nullptr;
+  Counters m_counters;
+  GLuint m_array_buffer = c_unknown;
+  GLuint m_element_buffer = c_unknown;
+  GLuint m_program = c_unknown;
+  GLuint m_framebuffer = c_unknown;
+  GLuint m_vertex_array = c_unknown;
+  GLuint m_active_unit = c_unknown;
+  std::array<GLuint, c_num_units> m_textures;
+  std::array<int8_t, c_num_caps> m_caps;
+};
+
+} // namespace gles2
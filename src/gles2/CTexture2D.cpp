@@ -25,22 +25,82 @@
 #include "CTexture2D.hpp"
 
 #include <FreeImage.h>
+#include <algorithm>
 #include <iostream>
 #include <utility>
 
+#include "CStateCache.hpp"
+#include "Etc.hpp"
+#include "Extensions.hpp"
+#include "Ktx.hpp"
+#include "Swizzle.hpp"
+
 namespace gles2 {
 
+namespace {
+
+bool isPowerOfTwo(unsigned value)
+{
+  return value && !(value & (value - 1));
+}
+
+unsigned nextPowerOfTwo(unsigned value)
+{
+  unsigned pot = 1;
+  while (pot < value)
+  {
+    pot *= 2;
+  }
+  return pot;
+}
+
+std::size_t texelBytes(GLint format)
+{
+  switch (format)
+  {
+  case GL_RGBA:
+    return 4;
+  case GL_RGB:
+    return 3;
+  case GL_LUMINANCE_ALPHA:
+    return 2;
+  default:
+    return 1;
+  }
+}
+
+glm::uvec2 mipSize(const glm::uvec2 &size)
+{
+  return glm::uvec2(std::max(size.x / 2, 1u), std::max(size.y / 2, 1u));
+}
+
+std::size_t mipLevels(glm::uvec2 size)
+{
+  std::size_t levels = 1;
+  for (; size.x > 1 || size.y > 1; size = mipSize(size))
+  {
+    ++levels;
+  }
+  return levels;
+}
+
+} // namespace
+
 CTexture2D::CTexture2D(
     const glm::uvec2 &size,
     GLint format,
-    const uint8_t *data)
+    const uint8_t *data,
+    GLint filter)
   : m_size(size)
+  , m_image_size(size)
+  , m_format(format)
+  , m_mipmapped(false)
 {
   glGenTextures(1, &m_id);
 
-  glBindTexture(GL_TEXTURE_2D, m_id);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  CStateCache::current().bindTexture(0, m_id);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
   glTexImage2D(
       GL_TEXTURE_2D,
       0,
@@ -51,12 +111,57 @@ CTexture2D::CTexture2D(
       format,
       GL_UNSIGNED_BYTE,
       data);
-  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+CTexture2D::CTexture2D(const Decoded &compressed)
+  : m_size(compressed.size)
+  , m_image_size(compressed.image_size)
+  , m_format(compressed.format)
+  , m_mipmapped(false)
+{
+  // GLES2 has no GL_TEXTURE_MAX_LEVEL, a partial chain would leave the
+  // texture incomplete
+  const std::size_t levels = compressed.levels.size();
+  if (levels > 1)
+  {
+    m_mipmapped = (levels == mipLevels(m_size)) && canMipmap(m_size);
+    if (!m_mipmapped)
+    {
+      std::cerr << "Ignoring the incomplete or NPOT mip chain" << std::endl;
+    }
+  }
+
+  glGenTextures(1, &m_id);
+  CStateCache::current().bindTexture(0, m_id);
+  glTexParameteri(
+      GL_TEXTURE_2D,
+      GL_TEXTURE_MIN_FILTER,
+      m_mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  const uint8_t *data = compressed.pixels.data();
+  glm::uvec2 size = m_size;
+  for (std::size_t level = 0; level < (m_mipmapped ? levels : 1); ++level)
+  {
+    glCompressedTexImage2D(
+        GL_TEXTURE_2D,
+        level,
+        m_format,
+        size.x,
+        size.y,
+        0,
+        compressed.levels[level],
+        data);
+    data += compressed.levels[level];
+    size = mipSize(size);
+  }
 }
 
 CTexture2D::CTexture2D(CTexture2D &&rhs) noexcept
   : m_id(std::move(rhs.m_id))
   , m_size(std::move(rhs.m_size))
+  , m_image_size(std::move(rhs.m_image_size))
+  , m_format(std::move(rhs.m_format))
+  , m_mipmapped(std::move(rhs.m_mipmapped))
 {
   rhs.m_id = 0u;
 }
@@ -65,29 +170,130 @@ CTexture2D &CTexture2D::operator=(CTexture2D &&rhs) noexcept
 {
   std::swap(m_id, rhs.m_id);
   std::swap(m_size, rhs.m_size);
+  std::swap(m_image_size, rhs.m_image_size);
+  std::swap(m_format, rhs.m_format);
+  std::swap(m_mipmapped, rhs.m_mipmapped);
   rhs.m_id = 0;
   return *this;
 }
 
 CTexture2D::~CTexture2D()
 {
-  glDeleteTextures(1, &m_id);
+  CStateCache::current().deleteTexture(m_id);
+}
+
+bool CTexture2D::compressed() const
+{
+  return 0 != etcBlockBytes(m_format);
+}
+
+std::size_t CTexture2D::bytes() const
+{
+  std::size_t bytes = 0;
+  glm::uvec2 size = m_size;
+  for (std::size_t level = 0; level < (m_mipmapped ? mipLevels(m_size) : 1);
+       ++level)
+  {
+    bytes += compressed() ? etcLevelBytes(m_format, size)
+                          : std::size_t{size.x} * size.y * texelBytes(m_format);
+    size = mipSize(size);
+  }
+  return bytes;
+}
+
+void CTexture2D::update(const uint8_t *data)
+{
+  if (compressed())
+  {
+    throw std::runtime_error("can't update a compressed texture");
+  }
+
+  CStateCache::current().bindTexture(0, m_id);
+  glTexSubImage2D(
+      GL_TEXTURE_2D,
+      0,
+      0,
+      0,
+      m_size.x,
+      m_size.y,
+      m_format,
+      GL_UNSIGNED_BYTE,
+      data);
+  if (m_mipmapped)
+  {
+    glGenerateMipmap(GL_TEXTURE_2D);
+  }
+}
+
+void CTexture2D::generateMipmaps()
+{
+  if (compressed())
+  {
+    throw std::runtime_error("GLES2 can't mipmap compressed textures");
+  }
+  if (!canMipmap(m_size))
+  {
+    throw std::runtime_error("GLES2 can't mipmap NPOT textures");
+  }
+
+  CStateCache::current().bindTexture(0, m_id);
+  glTexParameteri(
+      GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glGenerateMipmap(GL_TEXTURE_2D);
+  m_mipmapped = true;
+}
+
+void CTexture2D::setWrap(GLint wrap)
+{
+  CStateCache::current().bindTexture(0, m_id);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
 }
 
 void CTexture2D::bind(const CTexture2D &tex, std::size_t unit)
 {
-  glActiveTexture(GL_TEXTURE0 + unit);
-  glBindTexture(GL_TEXTURE_2D, tex.id());
+  CStateCache::current().bindTexture(unit, tex.id());
 }
 
 void CTexture2D::unbind(std::size_t unit)
 {
-  glActiveTexture(GL_TEXTURE0 + unit);
-  glBindTexture(GL_TEXTURE_2D, 0);
+  CStateCache::current().bindTexture(unit, 0);
 }
 
-CTexture2D CTexture2D::load(const std::string_view &path)
+bool CTexture2D::canMipmap(const glm::uvec2 &size)
 {
+  return (isPowerOfTwo(size.x) && isPowerOfTwo(size.y)) || canMipmapNpot();
+}
+
+bool CTexture2D::canMipmapNpot()
+{
+  return hasExtension("GL_OES_texture_npot");
+}
+
+bool CTexture2D::canCompress(GLenum format)
+{
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+  std::vector<GLint> formats(count);
+  glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+  return formats.end() !=
+         std::find(formats.begin(), formats.end(), static_cast<GLint>(format));
+}
+
+CTexture2D CTexture2D::load(const std::string_view &path, bool mipmaps)
+{
+  return upload(decode(path, mipmaps && !canMipmapNpot()), mipmaps);
+}
+
+CTexture2D::Decoded CTexture2D::decode(
+    const std::string_view &path,
+    bool pot_only)
+{
+  if (isKtxPath(path))
+  {
+    return readKtx(path);
+  }
+
   FIBITMAP *bitmap =
       FreeImage_Load(FreeImage_GetFileType(path.data(), 0), path.data());
   if (nullptr == bitmap)
@@ -96,6 +302,23 @@ CTexture2D CTexture2D::load(const std::string_view &path)
     throw TextureLoadError("load error");
   }
 
+  const glm::uvec2 size(
+      FreeImage_GetWidth(bitmap), FreeImage_GetHeight(bitmap));
+  if (pot_only && !(isPowerOfTwo(size.x) && isPowerOfTwo(size.y)))
+  {
+    FIBITMAP *scaled = FreeImage_Rescale(
+        bitmap,
+        nextPowerOfTwo(size.x),
+        nextPowerOfTwo(size.y),
+        FILTER_BILINEAR);
+    FreeImage_Unload(bitmap);
+    if (nullptr == scaled)
+    {
+      throw TextureLoadError("couldn't rescale image to power of two");
+    }
+    bitmap = scaled;
+  }
+
   int bpp = FreeImage_GetBPP(bitmap);
   if (bpp != 24 && bpp != 32)
   {
@@ -105,22 +328,52 @@ CTexture2D CTexture2D::load(const std::string_view &path)
   }
 
   // Swap red and blue channels, cannot use GL_BGR in OpenGL ES 2
+  static const SwapRedBlueFn swap_red_blue = selectSwapRedBlue();
   for (unsigned y = 0; y < FreeImage_GetHeight(bitmap); y++)
   {
-    BYTE *line = FreeImage_GetScanLine(bitmap, y);
-    for (unsigned x = 0; x < FreeImage_GetWidth(bitmap); x++)
-    {
-      std::swap(line[FI_RGBA_RED], line[FI_RGBA_BLUE]);
-      line += bpp / 8;
-    }
+    swap_red_blue(
+        FreeImage_GetScanLine(bitmap, y), FreeImage_GetWidth(bitmap), bpp / 8);
   }
 
-  gles2::CTexture2D texture(
+  // FreeImage pads rows to 4 bytes, as GL unpacks them by default
+  const uint8_t *bits = FreeImage_GetBits(bitmap);
+  Decoded image{
       {FreeImage_GetWidth(bitmap), FreeImage_GetHeight(bitmap)},
+      size,
       (bpp == 24) ? GL_RGB : GL_RGBA,
-      FreeImage_GetBits(bitmap));
-
+      std::vector<uint8_t>(
+          bits,
+          bits + std::size_t{FreeImage_GetPitch(bitmap)} *
+                     FreeImage_GetHeight(bitmap)),
+      {}};
   FreeImage_Unload(bitmap);
+  return image;
+}
+
+CTexture2D CTexture2D::upload(const Decoded &image, bool mipmaps)
+{
+  if (!image.levels.empty())
+  {
+    if (!canCompress(image.format))
+    {
+      std::cerr << "Driver doesn't take compressed format 0x" << std::hex
+                << image.format << std::dec << std::endl;
+      throw TextureLoadError("unsupported compressed format");
+    }
+    CTexture2D texture(image);
+    if (mipmaps && 1 == image.levels.size())
+    {
+      std::cerr << "Compressed image has no mip chain" << std::endl;
+    }
+    return texture;
+  }
+
+  gles2::CTexture2D texture(image.size, image.format, image.pixels.data());
+  texture.m_image_size = image.image_size;
+  if (mipmaps)
+  {
+    texture.generateMipmaps();
+  }
   return texture;
 }
 
@@ -25,9 +25,11 @@
 #pragma once
 
 #include <GLES2/gl2.h>
+#include <cstdint>
 #include <glm/vec2.hpp>
 #include <stdexcept>
 #include <string_view>
+#include <vector>
 
 namespace gles2 {
 
@@ -38,11 +40,25 @@ struct TextureLoadError : std::runtime_error
 
 class CTexture2D
 {
+public:
+  /// Image file decoded for upload(), rows are 4-byte aligned. Compressed
+  /// images have their internal format as format and the byte size of each
+  /// mip level, stored back to back in pixels, in levels.
+  struct Decoded
+  {
+    glm::uvec2 size;
+    glm::uvec2 image_size;
+    GLint format;
+    std::vector<uint8_t> pixels;
+    std::vector<std::size_t> levels;
+  };
+
 public:
   explicit CTexture2D(
       const glm::uvec2 &size,
       GLint format,
-      const uint8_t *data = nullptr);
+      const uint8_t *data = nullptr,
+      GLint filter = GL_LINEAR);
   CTexture2D(CTexture2D &&rhs) noexcept;
   CTexture2D &operator=(CTexture2D &&rhs) noexcept;
   CTexture2D(const CTexture2D &) = delete;
@@ -51,16 +67,54 @@ public:
 
   GLuint id() const { return m_id; }
   const glm::uvec2 &size() const { return m_size; }
+  /// Size of the loaded image, which load() may have rescaled to size().
+  const glm::uvec2 &imageSize() const { return m_image_size; }
+  GLint format() const { return m_format; }
+  bool mipmapped() const { return m_mipmapped; }
+  bool compressed() const;
+  /// Video memory of all levels.
+  std::size_t bytes() const;
+
+  /// Replaces all texels with glTexSubImage2D, keeping the storage. The
+  /// mip chain of a mipmapped texture is rebuilt. Throws std::runtime_error
+  /// for compressed textures.
+  void update(const uint8_t *data);
+
+  /// Builds the mip chain and switches minification to trilinear. Throws
+  /// std::runtime_error if !canMipmap(size()) or if compressed().
+  void generateMipmaps();
+
+  void setWrap(GLint wrap);
 
 public:
-  static CTexture2D load(const std::string_view &path);
+  /// With @p mipmaps, images GLES2 can't mipmap are rescaled to the next
+  /// power of two sizes first. KTX files are uploaded compressed, with the
+  /// mip levels they have.
+  static CTexture2D load(const std::string_view &path, bool mipmaps = false);
+
+  /// load() in two steps. decode() makes no GL calls and can run on any
+  /// thread, with @p pot_only it rescales NPOT images to power of two.
+  static Decoded decode(const std::string_view &path, bool pot_only = false);
+  static CTexture2D upload(const Decoded &image, bool mipmaps = false);
+
+  /// GLES2 mipmaps only power of two sizes, unless OES_texture_npot.
+  static bool canMipmap(const glm::uvec2 &size);
+  static bool canMipmapNpot();
+  /// Whether the driver lists @p format in GL_COMPRESSED_TEXTURE_FORMATS.
+  static bool canCompress(GLenum format);
 
   static void bind(const CTexture2D &tex, std::size_t unit = 0);
   static void unbind(std::size_t unit = 0);
 
+private:
+  explicit CTexture2D(const Decoded &compressed);
+
 private:
   GLuint m_id;
   glm::uvec2 m_size;
+  glm::uvec2 m_image_size;
+  GLint m_format;
+  bool m_mipmapped;
 };
 
 } // namespace gles2
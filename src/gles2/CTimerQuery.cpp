@@ -0,0 +1,143 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CTimerQuery.hpp"
+
+#include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
+#include <stdexcept>
+#include <utility>
+
+#include "Extensions.hpp"
+
+namespace gles2 {
+
+namespace {
+
+struct Functions
+{
+  PFNGLGENQUERIESEXTPROC gen = nullptr;
+  PFNGLDELETEQUERIESEXTPROC del = nullptr;
+  PFNGLBEGINQUERYEXTPROC begin = nullptr;
+  PFNGLENDQUERYEXTPROC end = nullptr;
+  PFNGLGETQUERYOBJECTUIVEXTPROC get_uint = nullptr;
+  PFNGLGETQUERYOBJECTUI64VEXTPROC get_uint64 = nullptr;
+  bool supported = false;
+
+  Functions()
+  {
+    if (hasExtension("GL_EXT_disjoint_timer_query"))
+    {
+      gen = reinterpret_cast<PFNGLGENQUERIESEXTPROC>(
+          eglGetProcAddress("glGenQueriesEXT"));
+      del = reinterpret_cast<PFNGLDELETEQUERIESEXTPROC>(
+          eglGetProcAddress("glDeleteQueriesEXT"));
+      begin = reinterpret_cast<PFNGLBEGINQUERYEXTPROC>(
+          eglGetProcAddress("glBeginQueryEXT"));
+      end = reinterpret_cast<PFNGLENDQUERYEXTPROC>(
+          eglGetProcAddress("glEndQueryEXT"));
+      get_uint = reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(
+          eglGetProcAddress("glGetQueryObjectuivEXT"));
+      get_uint64 = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(
+          eglGetProcAddress("glGetQueryObjectui64vEXT"));
+      supported = gen && del && begin && end && get_uint && get_uint64;
+    }
+  }
+};
+
+const Functions& functions()
+{
+  static const Functions s_functions;
+  return s_functions;
+}
+
+} // namespace
+
+CTimerQuery::CTimerQuery()
+  : m_id(0)
+{
+  if (!supported())
+  {
+    throw std::runtime_error("EXT_disjoint_timer_query is not supported");
+  }
+  functions().gen(1, &m_id);
+}
+
+CTimerQuery::CTimerQuery(CTimerQuery&& rhs) noexcept
+  : m_id(std::move(rhs.m_id))
+{
+  rhs.m_id = 0u;
+}
+
+CTimerQuery& CTimerQuery::operator=(CTimerQuery&& rhs) noexcept
+{
+  std::swap(m_id, rhs.m_id);
+  return *this;
+}
+
+CTimerQuery::~CTimerQuery()
+{
+  if (m_id)
+  {
+    functions().del(1, &m_id);
+  }
+}
+
+void CTimerQuery::begin()
+{
+  functions().begin(GL_TIME_ELAPSED_EXT, m_id);
+}
+
+void CTimerQuery::end()
+{
+  functions().end(GL_TIME_ELAPSED_EXT);
+}
+
+bool CTimerQuery::available() const
+{
+  GLuint available = GL_FALSE;
+  functions().get_uint(m_id, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+  return available != GL_FALSE;
+}
+
+uint64_t CTimerQuery::nanoseconds() const
+{
+  GLuint64 elapsed = 0;
+  functions().get_uint64(m_id, GL_QUERY_RESULT_EXT, &elapsed);
+  return elapsed;
+}
+
+bool CTimerQuery::supported()
+{
+  return functions().supported;
+}
+
+bool CTimerQuery::disjoint()
+{
+  GLint disjoint = GL_FALSE;
+  glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+  return disjoint != GL_FALSE;
+}
+
+} // namespace gles2
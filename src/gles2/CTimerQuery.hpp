@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <GLES2/gl2.h>
+#include <cstdint>
+
+namespace gles2 {
+
+/// GPU time spent on the commands between begin() and end(), from
+/// EXT_disjoint_timer_query. Check supported() before creating one. Only
+/// one query can be running at a time, results arrive some frames later.
+class CTimerQuery
+{
+public:
+  CTimerQuery();
+
+  CTimerQuery(CTimerQuery&& rhs) noexcept;
+  CTimerQuery& operator=(CTimerQuery&& rhs) noexcept;
+  CTimerQuery(const CTimerQuery&) = delete;
+  CTimerQuery& operator=(CTimerQuery&) = delete;
+  ~CTimerQuery();
+
+  GLuint id() const { return m_id; }
+
+  void begin();
+  void end();
+
+  /// Whether the result can be read without stalling.
+  bool available() const;
+  uint64_t nanoseconds() const;
+
+  /// Whether the extension is available, its entry points are looked up
+  /// on the first call.
+  static bool supported();
+
+  /// Whether something, like a GPU clock change, invalidated the running
+  /// and pending queries since the last call.
+  static bool disjoint();
+
+private:
+  GLuint m_id;
+};
+
+} // namespace gles2
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CVertexArray.hpp"
+
+#include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
+#include <stdexcept>
+#include <utility>
+
+#include "CStateCache.hpp"
+#include "Extensions.hpp"
+
+namespace gles2 {
+
+namespace {
+
+struct Functions
+{
+  PFNGLGENVERTEXARRAYSOESPROC gen = nullptr;
+  PFNGLDELETEVERTEXARRAYSOESPROC del = nullptr;
+  PFNGLBINDVERTEXARRAYOESPROC bind = nullptr;
+  bool supported = false;
+
+  Functions()
+  {
+    if (hasExtension("GL_OES_vertex_array_object"))
+    {
+      gen = reinterpret_cast<PFNGLGENVERTEXARRAYSOESPROC>(
+          eglGetProcAddress("glGenVertexArraysOES"));
+      del = reinterpret_cast<PFNGLDELETEVERTEXARRAYSOESPROC>(
+          eglGetProcAddress("glDeleteVertexArraysOES"));
+      bind = reinterpret_cast<PFNGLBINDVERTEXARRAYOESPROC>(
+          eglGetProcAddress("glBindVertexArrayOES"));
+      supported = gen && del && bind;
+    }
+  }
+};
+
+const Functions& functions()
+{
+  static const Functions s_functions;
+  return s_functions;
+}
+
+} // namespace
+
+CVertexArray::CVertexArray()
+  : m_id(0)
+{
+  if (!supported())
+  {
+    throw std::runtime_error("OES_vertex_array_object is not supported");
+  }
+  functions().gen(1, &m_id);
+}
+
+CVertexArray::CVertexArray(CVertexArray&& rhs) noexcept
+  : m_id(std::move(rhs.m_id))
+{
+  rhs.m_id = 0u;
+}
+
+CVertexArray& CVertexArray::operator=(CVertexArray&& rhs) noexcept
+{
+  std::swap(m_id, rhs.m_id);
+  return *this;
+}
+
+CVertexArray::~CVertexArray()
+{
+  if (m_id)
+  {
+    CStateCache::current().forgetVertexArray(m_id);
+    functions().del(1, &m_id);
+  }
+}
+
+bool CVertexArray::supported()
+{
+  return functions().supported;
+}
+
+void CVertexArray::bind(const CVertexArray& vao)
+{
+  if (CStateCache::current().changeVertexArray(vao.id()))
+  {
+    functions().bind(vao.id());
+  }
+}
+
+void CVertexArray::unbind()
+{
+  if (supported() && CStateCache::current().changeVertexArray(0))
+  {
+    functions().bind(0);
+  }
+}
+
+} // namespace gles2
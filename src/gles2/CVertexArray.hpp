@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <GLES2/gl2.h>
+
+namespace gles2 {
+
+/// Vertex array object from OES_vertex_array_object, check supported()
+/// before creating one.
+class CVertexArray
+{
+public:
+  CVertexArray();
+
+  CVertexArray(CVertexArray&& rhs) noexcept;
+  CVertexArray& operator=(CVertexArray&& rhs) noexcept;
+  CVertexArray(const CVertexArray&) = delete;
+  CVertexArray& operator=(CVertexArray&) = delete;
+  ~CVertexArray();
+
+  GLuint id() const { return m_id; }
+
+  /// Whether the extension is available, its entry points are looked up
+  /// on the first call.
+  static bool supported();
+
+  static void bind(const CVertexArray& vao);
+  static void unbind();
+
+private:
+  GLuint m_id;
+};
+
+} // namespace gles2
@@ -0,0 +1,459 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "Etc.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace gles2 {
+
+namespace {
+
+// Intensity modifiers {a, b} of ETC1, texel indices 0..3 pick +a, +b, -a, -b
+constexpr int c_etc1_modifiers[8][2] = {
+    {2, 8},
+    {5, 17},
+    {9, 29},
+    {13, 42},
+    {18, 60},
+    {24, 80},
+    {33, 106},
+    {47, 183}};
+
+constexpr int c_eac_modifiers[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},
+    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},
+    {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},
+    {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},
+    {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},
+    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},
+    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},
+    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},
+    {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+// Table 13 has a zero modifier, which encodes flat alpha exactly
+constexpr unsigned c_eac_flat_table = 13;
+constexpr unsigned c_eac_flat_index = 4;
+
+using Texel = std::array<int, 4>;
+
+/// 4x4 texels in the order ETC stores their indices, column by column.
+using Block = std::array<Texel, 16>;
+
+/// Tightly packed RGBA level, rows in the order of the source image.
+struct Level
+{
+  glm::uvec2 size;
+  std::vector<uint8_t> rgba;
+};
+
+int square(int value)
+{
+  return value * value;
+}
+
+int etc1Modifier(unsigned table, unsigned index)
+{
+  const int modifier = c_etc1_modifiers[table][index & 1];
+  return (index & 2) ? -modifier : modifier;
+}
+
+// Best table and texel indices for the @p texels of @p block around @p base
+int fitSubBlock(
+    const Block& block,
+    const std::array<unsigned, 8>& texels,
+    const std::array<int, 3>& base,
+    unsigned& best_table,
+    std::array<unsigned, 16>& indices)
+{
+  int best_error = std::numeric_limits<int>::max();
+  for (unsigned table = 0; table < 8; ++table)
+  {
+    int error = 0;
+    std::array<unsigned, 8> picked;
+    for (std::size_t i = 0; i < texels.size(); ++i)
+    {
+      const Texel& texel = block[texels[i]];
+      int texel_error = std::numeric_limits<int>::max();
+      for (unsigned index = 0; index < 4; ++index)
+      {
+        const int modifier = etc1Modifier(table, index);
+        int e = 0;
+        for (int c = 0; c < 3; ++c)
+        {
+          e += square(texel[c] - std::clamp(base[c] + modifier, 0, 255));
+        }
+        if (e < texel_error)
+        {
+          texel_error = e;
+          picked[i] = index;
+        }
+      }
+      error += texel_error;
+    }
+    if (error < best_error)
+    {
+      best_error = error;
+      best_table = table;
+      for (std::size_t i = 0; i < texels.size(); ++i)
+      {
+        indices[texels[i]] = picked[i];
+      }
+    }
+  }
+  return best_error;
+}
+
+// Tries both sub-block splits in the individual and the differential mode,
+// with the sub-block averages as base colors
+uint64_t encodeEtc1Block(const Block& block)
+{
+  uint64_t best_bits = 0;
+  int best_error = std::numeric_limits<int>::max();
+  for (unsigned flip = 0; flip < 2; ++flip)
+  {
+    std::array<std::array<unsigned, 8>, 2> halves;
+    std::array<std::array<int, 3>, 2> sums{};
+    std::array<std::size_t, 2> counts{};
+    for (unsigned i = 0; i < 16; ++i)
+    {
+      const unsigned x = i / 4;
+      const unsigned y = i % 4;
+      const unsigned half = flip ? (y / 2) : (x / 2);
+      halves[half][counts[half]++] = i;
+      for (int c = 0; c < 3; ++c)
+      {
+        sums[half][c] += block[i][c];
+      }
+    }
+
+    for (unsigned diff = 0; diff < 2; ++diff)
+    {
+      const int max_code = diff ? 31 : 15;
+      std::array<std::array<int, 3>, 2> codes;
+      std::array<std::array<int, 3>, 2> bases;
+      for (int h = 0; h < 2; ++h)
+      {
+        for (int c = 0; c < 3; ++c)
+        {
+          codes[h][c] = static_cast<int>(
+              std::lround(sums[h][c] / 8.0 * max_code / 255.0));
+          bases[h][c] = diff ? (codes[h][c] << 3) | (codes[h][c] >> 2)
+                             : (codes[h][c] << 4) | codes[h][c];
+        }
+      }
+      bool fits = true;
+      for (int c = 0; c < 3 && diff; ++c)
+      {
+        const int delta = codes[1][c] - codes[0][c];
+        fits &= (delta >= -4 && delta <= 3);
+      }
+      if (!fits)
+      {
+        continue;
+      }
+
+      std::array<unsigned, 2> tables;
+      std::array<unsigned, 16> indices;
+      const int error =
+          fitSubBlock(block, halves[0], bases[0], tables[0], indices) +
+          fitSubBlock(block, halves[1], bases[1], tables[1], indices);
+      if (error >= best_error)
+      {
+        continue;
+      }
+
+      best_error = error;
+      uint64_t bits = 0;
+      for (int c = 0; c < 3; ++c)
+      {
+        if (diff)
+        {
+          bits |= uint64_t(codes[0][c]) << (59 - 8 * c);
+          bits |= uint64_t((codes[1][c] - codes[0][c]) & 7) << (56 - 8 * c);
+        }
+        else
+        {
+          bits |= uint64_t(codes[0][c]) << (60 - 8 * c);
+          bits |= uint64_t(codes[1][c]) << (56 - 8 * c);
+        }
+      }
+      bits |= uint64_t(tables[0]) << 37;
+      bits |= uint64_t(tables[1]) << 34;
+      bits |= uint64_t(diff) << 33;
+      bits |= uint64_t(flip) << 32;
+      for (unsigned i = 0; i < 16; ++i)
+      {
+        bits |= uint64_t(indices[i] >> 1) << (16 + i);
+        bits |= uint64_t(indices[i] & 1) << i;
+      }
+      best_bits = bits;
+    }
+  }
+  return best_bits;
+}
+
+// Error of the best texel indices for the EAC parameters, filled in
+// @p indices
+int fitEac(
+    const Block& block,
+    int base,
+    int multiplier,
+    unsigned table,
+    std::array<unsigned, 16>& indices)
+{
+  int error = 0;
+  for (unsigned i = 0; i < 16; ++i)
+  {
+    int texel_error = std::numeric_limits<int>::max();
+    for (unsigned index = 0; index < 8; ++index)
+    {
+      const int value = std::clamp(
+          base + c_eac_modifiers[table][index] * multiplier, 0, 255);
+      const int e = square(block[i][3] - value);
+      if (e < texel_error)
+      {
+        texel_error = e;
+        indices[i] = index;
+      }
+    }
+    error += texel_error;
+  }
+  return error;
+}
+
+uint64_t encodeEacAlphaBlock(const Block& block)
+{
+  int min_alpha = 255;
+  int max_alpha = 0;
+  for (const Texel& texel : block)
+  {
+    min_alpha = std::min(min_alpha, texel[3]);
+    max_alpha = std::max(max_alpha, texel[3]);
+  }
+
+  int best_base = min_alpha;
+  int best_multiplier = 1;
+  unsigned best_table = c_eac_flat_table;
+  std::array<unsigned, 16> best_indices;
+  best_indices.fill(c_eac_flat_index);
+  if (min_alpha != max_alpha)
+  {
+    // Only multipliers stretching the table over the alpha range are tried
+    int best_error = std::numeric_limits<int>::max();
+    std::array<unsigned, 16> indices;
+    for (unsigned table = 0; table < 16; ++table)
+    {
+      const int low = c_eac_modifiers[table][3];
+      const int high = c_eac_modifiers[table][7];
+      const double stretch = double(max_alpha - min_alpha) / (high - low);
+      for (double rounded : {std::floor(stretch), std::ceil(stretch)})
+      {
+        const int multiplier = std::clamp(static_cast<int>(rounded), 1, 15);
+        const int center = static_cast<int>(std::lround(
+            (min_alpha + max_alpha) / 2.0 - (low + high) * multiplier / 2.0));
+        for (int base = center - 1; base <= center + 1; ++base)
+        {
+          if (base < 0 || base > 255)
+          {
+            continue;
+          }
+          const int error = fitEac(block, base, multiplier, table, indices);
+          if (error < best_error)
+          {
+            best_error = error;
+            best_base = base;
+            best_multiplier = multiplier;
+            best_table = table;
+            best_indices = indices;
+          }
+        }
+      }
+    }
+  }
+
+  uint64_t bits = uint64_t(best_base) << 56;
+  bits |= uint64_t(best_multiplier) << 52;
+  bits |= uint64_t(best_table) << 48;
+  for (unsigned i = 0; i < 16; ++i)
+  {
+    bits |= uint64_t(best_indices[i]) << (45 - 3 * i);
+  }
+  return bits;
+}
+
+void storeBigEndian(uint64_t bits, uint8_t* out)
+{
+  for (int i = 0; i < 8; ++i)
+  {
+    out[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+  }
+}
+
+Level toRgba(const CTexture2D::Decoded& image)
+{
+  const std::size_t channels = (image.format == GL_RGB) ? 3 : 4;
+  const std::size_t pitch = (image.size.x * channels + 3) & ~std::size_t{3};
+  Level level{image.size, std::vector<uint8_t>(
+                              std::size_t{image.size.x} * image.size.y * 4)};
+  for (unsigned y = 0; y < image.size.y; ++y)
+  {
+    const uint8_t* src = image.pixels.data() + y * pitch;
+    uint8_t* dst = level.rgba.data() + std::size_t{y} * image.size.x * 4;
+    for (unsigned x = 0; x < image.size.x; ++x)
+    {
+      dst[0] = src[0];
+      dst[1] = src[1];
+      dst[2] = src[2];
+      dst[3] = (4 == channels) ? src[3] : 255;
+      src += channels;
+      dst += 4;
+    }
+  }
+  return level;
+}
+
+// Box filter, odd sizes round down like GL mip levels do
+Level halve(const Level& level)
+{
+  const glm::uvec2 size(
+      std::max(level.size.x / 2, 1u), std::max(level.size.y / 2, 1u));
+  Level half{size, std::vector<uint8_t>(std::size_t{size.x} * size.y * 4)};
+  for (unsigned y = 0; y < size.y; ++y)
+  {
+    for (unsigned x = 0; x < size.x; ++x)
+    {
+      const unsigned x0 = std::min(2 * x, level.size.x - 1);
+      const unsigned x1 = std::min(2 * x + 1, level.size.x - 1);
+      const unsigned y0 = std::min(2 * y, level.size.y - 1);
+      const unsigned y1 = std::min(2 * y + 1, level.size.y - 1);
+      for (unsigned c = 0; c < 4; ++c)
+      {
+        auto at = [&](unsigned sx, unsigned sy) {
+          return unsigned{
+              level.rgba[(std::size_t{sy} * level.size.x + sx) * 4 + c]};
+        };
+        half.rgba[(std::size_t{y} * size.x + x) * 4 + c] = static_cast<uint8_t>(
+            (at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1) + 2) / 4);
+      }
+    }
+  }
+  return half;
+}
+
+// Edge blocks repeat the last column and row
+void encodeLevel(const Level& level, GLenum format, uint8_t* out)
+{
+  for (unsigned by = 0; by < level.size.y; by += 4)
+  {
+    for (unsigned bx = 0; bx < level.size.x; bx += 4)
+    {
+      Block block;
+      for (unsigned i = 0; i < 16; ++i)
+      {
+        const unsigned x = std::min(bx + i / 4, level.size.x - 1);
+        const unsigned y = std::min(by + i % 4, level.size.y - 1);
+        const uint8_t* texel =
+            &level.rgba[(std::size_t{y} * level.size.x + x) * 4];
+        block[i] = {texel[0], texel[1], texel[2], texel[3]};
+      }
+      if (c_etc2_rgba8_eac == format)
+      {
+        storeBigEndian(encodeEacAlphaBlock(block), out);
+        out += 8;
+      }
+      storeBigEndian(encodeEtc1Block(block), out);
+      out += 8;
+    }
+  }
+}
+
+} // namespace
+
+std::size_t etcBlockBytes(GLenum format)
+{
+  switch (format)
+  {
+  case c_etc1_rgb8:
+  case c_etc2_rgb8:
+    return 8;
+  case c_etc2_rgba8_eac:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+std::size_t etcLevelBytes(GLenum format, const glm::uvec2& size)
+{
+  return std::size_t{(size.x + 3) / 4} * ((size.y + 3) / 4) *
+         etcBlockBytes(format);
+}
+
+CTexture2D::Decoded compressEtc(
+    const CTexture2D::Decoded& image,
+    GLenum format,
+    bool mipmaps)
+{
+  if (0 == etcBlockBytes(format))
+  {
+    throw std::runtime_error("not an ETC format");
+  }
+  if (!image.levels.empty() ||
+      (image.format != GL_RGB && image.format != GL_RGBA))
+  {
+    throw std::runtime_error("can only compress RGB and RGBA images");
+  }
+
+  CTexture2D::Decoded compressed{
+      image.size, image.image_size, static_cast<GLint>(format), {}, {}};
+  Level level = toRgba(image);
+  while (true)
+  {
+    const std::size_t bytes = etcLevelBytes(format, level.size);
+    const std::size_t offset = compressed.pixels.size();
+    compressed.pixels.resize(offset + bytes);
+    encodeLevel(level, format, compressed.pixels.data() + offset);
+    compressed.levels.push_back(bytes);
+    if (!mipmaps || (1 == level.size.x && 1 == level.size.y))
+    {
+      break;
+    }
+    level = halve(level);
+  }
+  return compressed;
+}
+
+} // namespace gles2
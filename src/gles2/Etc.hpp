@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <GLES2/gl2.h>
+#include <cstddef>
+
+#include "CTexture2D.hpp"
+
+namespace gles2 {
+
+/// ETC2 formats are core in GLES3 only, GLES2 drivers list them in
+/// GL_COMPRESSED_TEXTURE_FORMATS when they take them anyway.
+constexpr GLenum c_etc1_rgb8 = 0x8D64;
+constexpr GLenum c_etc2_rgb8 = 0x9274;
+constexpr GLenum c_etc2_rgba8_eac = 0x9278;
+
+/// Bytes of one 4x4 block of @p format, 0 unless it's one of the above.
+std::size_t etcBlockBytes(GLenum format);
+std::size_t etcLevelBytes(GLenum format, const glm::uvec2& size);
+
+/// Compresses a decoded GL_RGB or GL_RGBA image to @p format, with
+/// @p mipmaps the whole chain down to 1x1 is stored after the base level.
+/// ETC2 RGB data is plain ETC1, which every ETC2 decoder takes. Slow, meant
+/// for converting images offline.
+CTexture2D::Decoded compressEtc(
+    const CTexture2D::Decoded& image,
+    GLenum format,
+    bool mipmaps = false);
+
+} // namespace gles2
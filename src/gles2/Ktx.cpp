@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "Ktx.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "Etc.hpp"
+
+namespace gles2 {
+
+namespace {
+
+constexpr std::array<uint8_t, 12> c_identifier = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+constexpr uint32_t c_endianness = 0x04030201;
+
+// Texture coordinates grow right and up, as GL orders the rows
+constexpr char c_orientation[] = "KTXorientation\0S=r,T=u";
+
+struct Header
+{
+  uint32_t endianness;
+  uint32_t gl_type;
+  uint32_t gl_type_size;
+  uint32_t gl_format;
+  uint32_t gl_internal_format;
+  uint32_t gl_base_internal_format;
+  uint32_t pixel_width;
+  uint32_t pixel_height;
+  uint32_t pixel_depth;
+  uint32_t number_of_array_elements;
+  uint32_t number_of_faces;
+  uint32_t number_of_mipmap_levels;
+  uint32_t bytes_of_key_value_data;
+};
+
+std::size_t padded(std::size_t bytes)
+{
+  return (bytes + 3) & ~std::size_t{3};
+}
+
+void writeWord(std::ostream& os, uint32_t word)
+{
+  os.write(reinterpret_cast<const char*>(&word), sizeof(word));
+}
+
+} // namespace
+
+bool isKtxPath(const std::string_view& path)
+{
+  constexpr std::string_view extension = ".ktx";
+  return path.size() > extension.size() &&
+         std::equal(
+             extension.begin(),
+             extension.end(),
+             path.end() - extension.size(),
+             [](char a, char b) { return a == std::tolower(b); });
+}
+
+CTexture2D::Decoded readKtx(const std::string_view& path)
+{
+  std::ifstream file(std::string(path), std::ios::binary);
+  std::array<uint8_t, 12> identifier{};
+  Header header{};
+  file.read(reinterpret_cast<char*>(identifier.data()), identifier.size());
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!file || identifier != c_identifier)
+  {
+    std::cerr << "Couldn't load KTX file " << path << std::endl;
+    throw TextureLoadError("load error");
+  }
+  if (header.endianness != c_endianness)
+  {
+    throw TextureLoadError("big endian KTX files are not supported");
+  }
+  if (0 == etcBlockBytes(header.gl_internal_format) || 0 != header.gl_type)
+  {
+    throw TextureLoadError("KTX file isn't ETC compressed");
+  }
+  if (0 == header.pixel_width || 0 == header.pixel_height ||
+      0 != header.pixel_depth || header.number_of_array_elements > 1 ||
+      1 != header.number_of_faces)
+  {
+    throw TextureLoadError("KTX file isn't a single 2D image");
+  }
+
+  const glm::uvec2 size(header.pixel_width, header.pixel_height);
+  CTexture2D::Decoded image{
+      size, size, static_cast<GLint>(header.gl_internal_format), {}, {}};
+  file.ignore(header.bytes_of_key_value_data);
+  glm::uvec2 level_size = size;
+  for (uint32_t level = 0;
+       level < std::max(header.number_of_mipmap_levels, 1u);
+       ++level)
+  {
+    uint32_t image_size = 0;
+    file.read(reinterpret_cast<char*>(&image_size), sizeof(image_size));
+    if (!file || image_size != etcLevelBytes(image.format, level_size))
+    {
+      throw TextureLoadError("truncated KTX file");
+    }
+    const std::size_t offset = image.pixels.size();
+    image.pixels.resize(offset + image_size);
+    file.read(reinterpret_cast<char*>(&image.pixels[offset]), image_size);
+    file.ignore(padded(image_size) - image_size);
+    if (!file)
+    {
+      throw TextureLoadError("truncated KTX file");
+    }
+    image.levels.push_back(image_size);
+    level_size = glm::uvec2(
+        std::max(level_size.x / 2, 1u), std::max(level_size.y / 2, 1u));
+  }
+  return image;
+}
+
+void writeKtx(const std::string& path, const CTexture2D::Decoded& image)
+{
+  if (image.levels.empty() || 0 == etcBlockBytes(image.format))
+  {
+    throw std::runtime_error("KTX files hold ETC compressed images only");
+  }
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  const Header header{
+      c_endianness,
+      0,
+      1,
+      0,
+      static_cast<uint32_t>(image.format),
+      static_cast<uint32_t>(
+          (c_etc2_rgba8_eac == image.format) ? GL_RGBA : GL_RGB),
+      image.size.x,
+      image.size.y,
+      0,
+      0,
+      1,
+      static_cast<uint32_t>(image.levels.size()),
+      static_cast<uint32_t>(4 + padded(sizeof(c_orientation)))};
+  file.write(
+      reinterpret_cast<const char*>(c_identifier.data()), c_identifier.size());
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  writeWord(file, sizeof(c_orientation));
+  file.write(c_orientation, sizeof(c_orientation));
+  file.write("\0\0\0", padded(sizeof(c_orientation)) - sizeof(c_orientation));
+
+  const uint8_t* data = image.pixels.data();
+  for (std::size_t bytes : image.levels)
+  {
+    writeWord(file, static_cast<uint32_t>(bytes));
+    file.write(reinterpret_cast<const char*>(data), bytes);
+    file.write("\0\0\0", padded(bytes) - bytes);
+    data += bytes;
+  }
+  if (!file.flush())
+  {
+    std::cerr << "Couldn't write KTX file " << path << std::endl;
+    throw std::runtime_error("write error");
+  }
+}
+
+} // namespace gles2
@@ -0,0 +1,46 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "CTexture2D.hpp"
+
+namespace gles2 {
+
+/// KTX 1.1 files of one compressed 2D image and its mip levels, which
+/// CTexture2D::decode() picks by the .ktx extension.
+bool isKtxPath(const std::string_view& path);
+
+/// Reads a little endian KTX file of an ETC format. Throws
+/// TextureLoadError.
+CTexture2D::Decoded readKtx(const std::string_view& path);
+
+/// Writes a compressed image, rows keep the bottom-up order of GL. Throws
+/// std::runtime_error.
+void writeKtx(const std::string& path, const CTexture2D::Decoded& image);
+
+} // namespace gles2
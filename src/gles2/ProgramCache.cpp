@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "ProgramCache.hpp"
+
+#include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Extensions.hpp"
+
+namespace gles2 {
+
+namespace {
+
+constexpr uint32_t c_magic = 0x42505744; // "DWPB" little endian
+
+struct Functions
+{
+  PFNGLGETPROGRAMBINARYOESPROC get = nullptr;
+  PFNGLPROGRAMBINARYOESPROC load = nullptr;
+  bool supported = false;
+
+  Functions()
+  {
+    if (hasExtension("GL_OES_get_program_binary"))
+    {
+      get = reinterpret_cast<PFNGLGETPROGRAMBINARYOESPROC>(
+          eglGetProcAddress("glGetProgramBinaryOES"));
+      load = reinterpret_cast<PFNGLPROGRAMBINARYOESPROC>(
+          eglGetProcAddress("glProgramBinaryOES"));
+      GLint num_formats = 0;
+      glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &num_formats);
+      supported = get && load && num_formats > 0;
+    }
+  }
+};
+
+const Functions& functions()
+{
+  static const Functions s_functions;
+  return s_functions;
+}
+
+std::filesystem::path& cacheDir()
+{
+  static std::filesystem::path s_dir;
+  return s_dir;
+}
+
+// FNV-1a, the key only has to tell sources and drivers apart
+void hash(uint64_t& state, const std::string_view& data)
+{
+  for (unsigned char c : data)
+  {
+    state = (state ^ c) * 0x100000001b3ull;
+  }
+  state = (state ^ 0xff) * 0x100000001b3ull;
+}
+
+std::string_view glString(GLenum name)
+{
+  const auto* value = reinterpret_cast<const char*>(glGetString(name));
+  return value ? value : "";
+}
+
+struct BinaryHeader
+{
+  uint32_t magic;
+  uint32_t format;
+  uint32_t length;
+};
+
+} // namespace
+
+void setProgramCacheDir(const std::string& dir)
+{
+  cacheDir() = dir;
+}
+
+bool programCacheEnabled()
+{
+  return !cacheDir().empty() && functions().supported;
+}
+
+std::string programCacheKey(
+    const std::string_view& vert_source,
+    const std::string_view& frag_source)
+{
+  uint64_t state = 0xcbf29ce484222325ull;
+  hash(state, vert_source);
+  hash(state, frag_source);
+  hash(state, glString(GL_VENDOR));
+  hash(state, glString(GL_RENDERER));
+  hash(state, glString(GL_VERSION));
+
+  char key[17];
+  std::snprintf(
+      key, sizeof(key), "%016llx", static_cast<unsigned long long>(state));
+  return key;
+}
+
+bool loadProgramBinary(GLuint program, const std::string& key)
+{
+  const std::filesystem::path path = cacheDir() / (key + ".bin");
+  std::error_code error;
+  const std::uintmax_t file_size = std::filesystem::file_size(path, error);
+  std::ifstream file(path, std::ios::binary);
+  BinaryHeader header{};
+  if (error ||
+      !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      header.magic != c_magic)
+  {
+    return false;
+  }
+  // A damaged length mustn't become the allocation size
+  if (header.length == 0 || file_size != sizeof(header) + header.length)
+  {
+    return false;
+  }
+  std::vector<char> binary(header.length);
+  if (!file.read(binary.data(), binary.size()))
+  {
+    return false;
+  }
+
+  functions().load(
+      program,
+      header.format,
+      binary.data(),
+      static_cast<GLint>(binary.size()));
+  GLint success = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  return success != GL_FALSE;
+}
+
+void storeProgramBinary(GLuint program, const std::string& key)
+{
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+  if (length <= 0)
+  {
+    return;
+  }
+  std::vector<char> binary(length);
+  GLenum format = GL_NONE;
+  functions().get(program, length, &length, &format, binary.data());
+
+  // Written aside and renamed, concurrent starts never read half a file.
+  // Every writer has its own, or one could rename another's unfinished.
+  static std::atomic<unsigned> s_temp_count{0};
+  std::error_code error;
+  std::filesystem::create_directories(cacheDir(), error);
+  const std::filesystem::path path = cacheDir() / (key + ".bin");
+  const std::filesystem::path temp =
+      cacheDir() / (key + "." + std::to_string(getpid()) + "." +
+                    std::to_string(s_temp_count++) + ".tmp");
+  bool written = false;
+  {
+    std::ofstream file(temp, std::ios::binary);
+    const BinaryHeader header{
+        c_magic, format, static_cast<uint32_t>(length)};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), length);
+    file.close();
+    written = static_cast<bool>(file);
+  }
+  if (!written)
+  {
+    std::cerr << "Couldn't cache program binary " << temp << std::endl;
+    std::filesystem::remove(temp, error);
+    return;
+  }
+  std::filesystem::rename(temp, path, error);
+  if (error)
+  {
+    std::filesystem::remove(temp, error);
+  }
+}
+
+} // namespace gles2
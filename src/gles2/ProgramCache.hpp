@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <GLES2/gl2.h>
+#include <string>
+#include <string_view>
+
+namespace gles2 {
+
+/// On-disk cache of linked programs through OES_get_program_binary, used by
+/// CShaderProgram. Disabled until a directory is set, and whenever the
+/// driver offers no binary format.
+void setProgramCacheDir(const std::string& dir);
+bool programCacheEnabled();
+
+/// Hash of the sources and of the vendor, renderer and version strings, so
+/// a driver update never gets binaries of the old one.
+std::string programCacheKey(
+    const std::string_view& vert_source,
+    const std::string_view& frag_source);
+
+/// Links @p program from the binary cached under @p key. Files whose size
+/// disagrees with their header are skipped, stale binaries are rejected by
+/// the driver, false means compile from source.
+bool loadProgramBinary(GLuint program, const std::string& key);
+void storeProgramBinary(GLuint program, const std::string& key);
+
+} // namespace gles2
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "Swizzle.hpp"
+
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define GLES2_SWIZZLE_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GLES2_SWIZZLE_NEON 1
+#endif
+
+namespace gles2 {
+
+namespace {
+
+#ifdef GLES2_SWIZZLE_X86
+
+__attribute__((target("ssse3"))) void swapRedBlueSsse3(
+    uint8_t* pixels,
+    std::size_t count,
+    std::size_t bytes_per_pixel)
+{
+  std::size_t i = 0;
+  if (4 == bytes_per_pixel)
+  {
+    const __m128i mask =
+        _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    for (; i + 4 <= count; i += 4)
+    {
+      auto p = reinterpret_cast<__m128i*>(pixels + 4 * i);
+      _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+    }
+  }
+  else
+  {
+    // 16 pixels in three registers, pixels 5 and 10 straddle two of them
+    // and take their missing byte from the neighbour (-1 zeroes a byte)
+    const __m128i in0 =
+        _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, -1);
+    const __m128i in1 =
+        _mm_setr_epi8(0, -1, 4, 3, 2, 7, 6, 5, 10, 9, 8, 13, 12, 11, -1, 15);
+    const __m128i in2 =
+        _mm_setr_epi8(-1, 3, 2, 1, 6, 5, 4, 9, 8, 7, 12, 11, 10, 15, 14, 13);
+    const __m128i from1_to0 = _mm_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1);
+    const __m128i from0_to1 = _mm_setr_epi8(
+        -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i from2_to1 = _mm_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, -1);
+    const __m128i from1_to2 = _mm_setr_epi8(
+        14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    for (; i + 16 <= count; i += 16)
+    {
+      auto p = reinterpret_cast<__m128i*>(pixels + 3 * i);
+      const __m128i r0 = _mm_loadu_si128(p);
+      const __m128i r1 = _mm_loadu_si128(p + 1);
+      const __m128i r2 = _mm_loadu_si128(p + 2);
+      _mm_storeu_si128(
+          p,
+          _mm_or_si128(
+              _mm_shuffle_epi8(r0, in0), _mm_shuffle_epi8(r1, from1_to0)));
+      _mm_storeu_si128(
+          p + 1,
+          _mm_or_si128(
+              _mm_shuffle_epi8(r1, in1),
+              _mm_or_si128(
+                  _mm_shuffle_epi8(r0, from0_to1),
+                  _mm_shuffle_epi8(r2, from2_to1))));
+      _mm_storeu_si128(
+          p + 2,
+          _mm_or_si128(
+              _mm_shuffle_epi8(r2, in2), _mm_shuffle_epi8(r1, from1_to2)));
+    }
+  }
+
+  swapRedBlueScalar(
+      pixels + bytes_per_pixel * i, count - i, bytes_per_pixel);
+}
+
+#endif
+
+#ifdef GLES2_SWIZZLE_NEON
+
+void swapRedBlueNeon(
+    uint8_t* pixels,
+    std::size_t count,
+    std::size_t bytes_per_pixel)
+{
+  std::size_t i = 0;
+  if (4 == bytes_per_pixel)
+  {
+    for (; i + 16 <= count; i += 16)
+    {
+      uint8x16x4_t p = vld4q_u8(pixels + 4 * i);
+      std::swap(p.val[0], p.val[2]);
+      vst4q_u8(pixels + 4 * i, p);
+    }
+  }
+  else
+  {
+    for (; i + 16 <= count; i += 16)
+    {
+      uint8x16x3_t p = vld3q_u8(pixels + 3 * i);
+      std::swap(p.val[0], p.val[2]);
+      vst3q_u8(pixels + 3 * i, p);
+    }
+  }
+
+  swapRedBlueScalar(
+      pixels + bytes_per_pixel * i, count - i, bytes_per_pixel);
+}
+
+#endif
+
+} // namespace
+
+void swapRedBlueScalar(
+    uint8_t* pixels,
+    std::size_t count,
+    std::size_t bytes_per_pixel)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    std::swap(pixels[0], pixels[2]);
+    pixels += bytes_per_pixel;
+  }
+}
+
+SwapRedBlueFn selectSwapRedBlue()
+{
+#if defined(GLES2_SWIZZLE_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("ssse3"))
+  {
+    return swapRedBlueSsse3;
+  }
+  return swapRedBlueScalar;
+#elif defined(GLES2_SWIZZLE_NEON)
+  return swapRedBlueNeon;
+#else
+  return swapRedBlueScalar;
+#endif
+}
+
+const char* swapRedBlueName(SwapRedBlueFn fn)
+{
+#if defined(GLES2_SWIZZLE_X86)
+  if (fn == swapRedBlueSsse3)
+  {
+    return "ssse3";
+  }
+#elif defined(GLES2_SWIZZLE_NEON)
+  if (fn == swapRedBlueNeon)
+  {
+    return "neon";
+  }
+#endif
+  return (fn == swapRedBlueScalar) ? "scalar" : "unknown";
+}
+
+} // namespace gles2
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gles2 {
+
+/// Swaps the first and the third byte of @p count pixels in place, which
+/// turns FreeImage BGR(A) rows into RGB(A) as there is no GL_BGR in GLES2.
+/// @p bytes_per_pixel is 3 or 4.
+using SwapRedBlueFn = void (*)(
+    uint8_t* pixels,
+    std::size_t count,
+    std::size_t bytes_per_pixel);
+
+void swapRedBlueScalar(
+    uint8_t* pixels,
+    std::size_t count,
+    std::size_t bytes_per_pixel);
+
+/// Picks the widest implementation the running CPU supports.
+SwapRedBlueFn selectSwapRedBlue();
+const char* swapRedBlueName(SwapRedBlueFn fn);
+
+} // namespace gles2
@@ -23,6 +23,7 @@
  *******************************************************************************/
 
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cstdlib>
@@ -33,23 +34,47 @@
 #include <glm/gtx/transform.hpp>
 #include <iomanip>
 #include <iostream>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <thread>
-
+#include <utility>
+#include <vector>
+
+#include "app/CFileWatcher.hpp"
+#include "app/CFrameProfiler.hpp"
+#include "app/CImageCache.hpp"
+#include "app/CTestPattern.hpp"
+#include "app/ExportLut.hpp"
+#include "app/Headless.hpp"
+#include "app/Options.hpp"
 #include "gles2/CBuffer.hpp"
 #include "gles2/CFrameBuffer.hpp"
 #include "gles2/CMesh.hpp"
+#include "gles2/CRenderTarget.hpp"
 #include "gles2/CShaderProgram.hpp"
+#include "gles2/CStateCache.hpp"
 #include "gles2/CTexture2D.hpp"
+#include "gles2/ProgramCache.hpp"
+#include "video/CFrameReader.hpp"
+#include "video/CFrameUploader.hpp"
+#include "video/CVideoStream.hpp"
+#include "video/SourceShader.hpp"
+#include "warp/CLutFile.hpp"
+#include "warp/CSplineSurface.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/EdgeBlend.hpp"
+#include "warp/KeyPoints.hpp"
+#include "warp/Shaders.hpp"
+#include "warp/SurfaceShader.hpp"
 
 namespace {
 
 constexpr glm::ivec2 c_wnd_size{640, 480};
 constexpr char c_wnd_title[] = "Distorted output";
 
-constexpr std::size_t c_num_points = 30;
 constexpr float c_shift_len = 0.01f;
 constexpr float c_zoom_factor = 1.05f;
 
@@ -57,84 +82,6 @@ constexpr std::array c_image_paths = {
     "bricks.png",
 };
 
-constexpr char c_img_vshader_src[] = R"(
-  precision highp float;
-  attribute vec3 a_pos;
-  attribute vec2 a_tex0;
-  uniform mat4 u_mvp;
-  varying vec2 v_tex0;
-
-  void main() {
-    gl_Position = u_mvp * vec4(a_pos, 1.0);
-    v_tex0 = a_tex0;
-  }
-)";
-
-constexpr char c_img_fshader_src[] = R"(
-  precision highp float;
-  uniform sampler2D u_tex;
-  varying vec2 v_tex0;
-
-  void main() {
-    gl_FragColor = texture2D(u_tex, v_tex0);
-  }
-)";
-
-constexpr char c_dbg_vshader_src[] = R"(
-  attribute vec3 a_pos;
-  attribute vec2 a_tex0;
-  uniform mat4 u_mvp;
-  uniform float u_pnt_sz;
-
-  void main() {
-    gl_PointSize = u_pnt_sz;
-    gl_Position = u_mvp * vec4(a_pos, 1.0);
-  }
-)";
-
-constexpr char c_dbg_fshader_src[] = R"(
-  precision mediump float;
-  uniform sampler2D u_tex;
-  uniform vec4 u_col;
-  varying vec2 v_tex0;
-
-  void main() {
-    gl_FragColor = u_col;
-  }
-)";
-
-/// Key points order:
-///
-/// P03 -- P13 -- P23 -- P33
-///  |      |      |      |
-/// P02 -- P12 -- P22 -- P32
-///  |      |      |      |
-/// P01 -- P11 -- P21 -- P31
-///  |      |      |      |
-/// P00 -- P10 -- P20 -- P30
-
-constexpr std::array c_key_points = {
-    /*P00*/ glm::vec2(-1.0, -1.0),
-    /*P01*/ glm::vec2(-1.0, -0.33333),
-    /*P02*/ glm::vec2(-1.0, 0.33333),
-    /*P03*/ glm::vec2(-1.0, 1.0),
-
-    /*P10*/ glm::vec2(-0.33333, -1.0),
-    /*P11*/ glm::vec2(-0.33333, -0.33333),
-    /*P12*/ glm::vec2(-0.33333, 0.33333),
-    /*P13*/ glm::vec2(-0.33333, 1.0),
-
-    /*P20*/ glm::vec2(0.33333, -1.0),
-    /*P21*/ glm::vec2(0.33333, -0.33333),
-    /*P22*/ glm::vec2(0.33333, 0.33333),
-    /*P23*/ glm::vec2(0.33333, 1.0),
-
-    /*P30*/ glm::vec2(1.0, -1.0),
-    /*P31*/ glm::vec2(1.0, -0.33333),
-    /*P32*/ glm::vec2(1.0, 0.33333),
-    /*P33*/ glm::vec2(1.0, 1.0),
-};
-
 constexpr std::pair<int, glm::vec2> c_shift_keys[] = {
     {GLFW_KEY_KP_4, glm::ivec2(-1, 0)},
     {GLFW_KEY_KP_6, glm::ivec2(1, 0)},
@@ -165,9 +112,16 @@ constexpr int c_save_kps_key = GLFW_KEY_F12;
 constexpr int c_close_wnd_key = GLFW_KEY_ESCAPE;
 constexpr int c_reset_points_key = GLFW_KEY_R;
 constexpr int c_reload_points_key = GLFW_KEY_L;
+constexpr int c_print_stats_key = GLFW_KEY_F1;
+constexpr int c_next_output_key = GLFW_KEY_TAB;
+constexpr int c_dump_profile_key = GLFW_KEY_F2;
 
 int g_pnt_index;
+std::size_t g_output_index;
+std::size_t g_num_outputs = 1;
+glm::ivec2 g_grid_size(warp::c_default_grid_size);
 int g_image_index;
+std::size_t g_num_images = c_image_paths.size();
 glm::vec2 g_shift;
 float g_img_zoom = 1.f;
 
@@ -178,215 +132,154 @@ bool g_request_to_save_kps;
 bool g_request_to_stop_wnd;
 bool g_request_to_reset_kps;
 bool g_request_to_reload_kps;
+bool g_request_to_print_stats;
+bool g_request_to_dump_profile;
+bool g_request_to_redraw = true;
 
-// gles2::CMesh generatePattern(std::size_t count)
-//{
-//  gles2::CMesh::Vertices dist_vertices;
-//  for (std::size_t i = 0; i < count; ++i) {
-//    float x = -1.f + 2.f * i / (count - 1);
-//    float u = static_cast<float>(i) / (count - 1);
-
-//    for (std::size_t j = 0; j < count; ++j) {
-//      float y = -1.f + 2.f * j / (count - 1);
-//      float v = 1.f - static_cast<float>(j) / (count - 1);
-
-//      dist_vertices.push_back({glm::vec3(x, y, 0.f), glm::vec2(u, v)});
-//    }
-//  }
-
-//  gles2::CMesh::Indices dist_indices;
-//  for (std::size_t i = 1; i < count; ++i) {
-//    for (std::size_t j = 0; j < count; ++j) {
-//      uint16_t x1 = (i - 1) * (count) + j;
-//      uint16_t x2 = (i - 1) * (count) + j + count;
-
-//      if (j == 0 && i != 1) {
-//        dist_indices.push_back(x1);
-//      }
-//      dist_indices.push_back(x1);
-//      dist_indices.push_back(x2);
-//    }
-//    dist_indices.push_back(dist_indices.back());
-//  }
-
-//  return gles2::CMesh(std::move(dist_vertices), std::move(dist_indices));
-//}
-
-gles2::CMesh generateDistortionMesh(
-    std::size_t count,
-    const std::array<glm::vec2, 16>& kps)
+/// One projector of the window: its own calibration, meshes and blend mask,
+/// drawn into its own column from the shared source.
+struct Output
 {
-  struct Math
-  {
-    static glm::vec2 bezier(
-        const glm::vec2& p0,
-        const glm::vec2& p1,
-        const glm::vec2& p2,
-        const glm::vec2& p3,
-        float u)
-    {
-      return std::pow(u, 3.f) * p3 + 3 * std::pow(u, 2.f) * (1.f - u) * p2 +
-             3 * u * std::pow(1.f - u, 2.f) * p1 + std::pow(1.f - u, 3.f) * p0;
-    }
-
-    static std::pair<std::vector<glm::vec2>, std::vector<glm::vec2>>
-    bezierControlPoints(std::vector<glm::vec2> knots)
-    {
-      // https://www.particleincell.com/2012/bezier-splines/
-      std::size_t num = knots.size() - 1;
-
-      std::vector<glm::vec2> p1(num);
-      std::vector<glm::vec2> p2(num);
-
-      /*rhs vector*/
-      std::vector<float> a(num);
-      std::vector<float> b(num);
-      std::vector<float> c(num);
-      std::vector<glm::vec2> r(num);
-
-      /*left most segment*/
-      a[0] = 0;
-      b[0] = 2;
-      c[0] = 1;
-      r[0] = knots[0] + knots[1] * 2.f;
-
-      /*internal segments*/
-      for (int i = 1; i < num - 1; i++)
-      {
-        a[i] = 1;
-        b[i] = 4;
-        c[i] = 1;
-        r[i] = knots[i] * 4.f + knots[i + 1] * 2.f;
-      }
-
-      /*right segment*/
-      a[num - 1] = 2;
-      b[num - 1] = 7;
-      c[num - 1] = 0;
-      r[num - 1] = knots[num - 1] * 8.f + knots[num];
-
-      /*solves Ax=b with the Thomas algorithm (from Wikipedia)*/
-      for (int i = 1; i < num; ++i)
-      {
-        float m = a[i] / b[i - 1];
-        b[i] = b[i] - c[i - 1] * m;
-        r[i] = r[i] - r[i - 1] * m;
-      }
-
-      p1[num - 1] = r[num - 1] / b[num - 1];
-      for (int i = num - 2; i >= 0; --i)
-      {
-        p1[i] = (r[i] - p1[i + 1] * c[i]) / b[i];
-      }
-
-      /*we have p1, now compute p2*/
-      for (int i = 0; i < num - 1; ++i)
-      {
-        p2[i] = knots[i + 1] * 2.f - p1[i + 1];
-      }
-
-      p2[num - 1] = (knots[num] + p1[num - 1]) * 0.5f;
-
-      return std::make_pair(p1, p2);
-    }
-  };
+  std::string kps_path;
+  warp::KeyPoints key_points;
+  /// Not generated while a baked LUT warps the output.
+  std::optional<gles2::CMesh> dist_mesh;
+  gles2::CMesh kps_mesh;
+  std::optional<gles2::CTexture2D> mask;
+  /// Pixel error of an adaptive dist_mesh.
+  float mesh_error;
+  /// Control net evaluated by the surface shaders, dist_mesh is the static
+  /// parameter grid then.
+  std::optional<warp::CSplineSurface> surface;
+};
 
-  gles2::CMesh::Vertices dist_vertices;
-  const auto & [ p1y0, p2y0 ] =
-      Math::bezierControlPoints({kps[0], kps[4], kps[8], kps[12]});
-  const auto & [ p1y1, p2y1 ] =
-      Math::bezierControlPoints({kps[1], kps[5], kps[9], kps[13]});
-  const auto & [ p1y2, p2y2 ] =
-      Math::bezierControlPoints({kps[2], kps[6], kps[10], kps[14]});
-  const auto & [ p1y3, p2y3 ] =
-      Math::bezierControlPoints({kps[3], kps[7], kps[11], kps[15]});
+gles2::CMesh generateOutputMesh(
+    const warp::KeyPoints& key_points,
+    const warp::MeshDensity& density,
+    bool gpu_surface,
+    float* mesh_error)
+{
+  return gpu_surface
+             ? warp::generateParameterMesh(density.count, key_points.size)
+             : warp::generateDistortionMesh(
+                   density, key_points, GL_DYNAMIC_DRAW, mesh_error);
+}
 
-  for (std::size_t i = 0; i < 3; ++i)
+/// Outputs warped by a baked LUT get no distortion mesh until their key
+/// points change. Throws std::invalid_argument if @p gpu_surface is asked
+/// for a grid too big for the surface shaders.
+Output makeOutput(
+    std::string kps_path,
+    warp::KeyPoints key_points,
+    const warp::MeshDensity& density,
+    bool gpu_surface,
+    bool baked = false)
+{
+  float mesh_error = 0.f;
+  std::optional<warp::CSplineSurface> surface;
+  if (gpu_surface)
   {
-    for (std::size_t ii = 0; ii < count / 3; ++ii)
+    if (!warp::canEvaluateSurface(key_points.size))
     {
-      float px = static_cast<float>(ii) / (count / 3 - 1);
-      glm::vec2 p0y = Math::bezier(
-          kps[4 * i + 0], p1y0[i], p2y0[i], kps[4 * (i + 1) + 0], px);
-      glm::vec2 p1y = Math::bezier(
-          kps[4 * i + 1], p1y1[i], p2y1[i], kps[4 * (i + 1) + 1], px);
-      glm::vec2 p2y = Math::bezier(
-          kps[4 * i + 2], p1y2[i], p2y2[i], kps[4 * (i + 1) + 2], px);
-      glm::vec2 p3y = Math::bezier(
-          kps[4 * i + 3], p1y3[i], p2y3[i], kps[4 * (i + 1) + 3], px);
-
-      std::vector<glm::vec2> knots = {p0y, p1y, p2y, p3y};
-      const auto & [ p1x0, p2x0 ] = Math::bezierControlPoints(knots);
-
-      for (std::size_t j = 0; j < 3; ++j)
-      {
-        for (std::size_t jj = 0; jj < count / 3; ++jj)
-        {
-          float py = static_cast<float>(jj) / (count / 3 - 1);
-          glm::vec2 p =
-              Math::bezier(knots[j], p1x0[j], p2x0[j], knots[j + 1], py);
-
-          dist_vertices.push_back(
-              {glm::vec3(std::move(p), 0.f),
-               glm::vec2(i / 3.f + 1 / 3.f * px, j / 3.f + 1 / 3.f * py)});
-        }
-      }
+      throw std::invalid_argument("grid is too big for the surface shaders");
     }
+    surface.emplace(key_points);
   }
+  std::optional<gles2::CMesh> dist_mesh;
+  if (!baked)
+  {
+    dist_mesh.emplace(
+        generateOutputMesh(key_points, density, gpu_surface, &mesh_error));
+  }
+  gles2::CMesh kps_mesh =
+      warp::generateKeyPointsMesh(key_points, GL_DYNAMIC_DRAW);
+  std::optional<gles2::CTexture2D> mask;
+  if (!key_points.blend.mask_path.empty())
+  {
+    mask.emplace(gles2::CTexture2D::load(key_points.blend.mask_path));
+  }
+  return {
+      std::move(kps_path),
+      std::move(key_points),
+      std::move(dist_mesh),
+      std::move(kps_mesh),
+      std::move(mask),
+      mesh_error,
+      std::move(surface)};
+}
 
-  //  gles2::CMesh::Vertices dist_vertices;
-  //  for (std::size_t i = 0; i < count; ++i) {
-  //    float px = static_cast<float>(i) / (count - 1);
-
-  //    glm::vec2 p0y = Math::bezier(kps[0], kps[4], kps[ 8], kps[12], px);
-  //    glm::vec2 p1y = Math::bezier(kps[1], kps[5], kps[ 9], kps[13], px);
-  //    glm::vec2 p2y = Math::bezier(kps[2], kps[6], kps[10], kps[14], px);
-  //    glm::vec2 p3y = Math::bezier(kps[3], kps[7], kps[11], kps[15], px);
-
-  //    for (std::size_t j = 0; j < count; ++j) {
-  //      float py = static_cast<float>(j) / (count - 1);
-  //      glm::vec2 p = Math::bezier(p0y, p1y, p2y, p3y, py);
-
-  //      dist_vertices.push_back(
-  //        {glm::vec3(std::move(p), 0.f), glm::vec2(px, py)});
-  //    }
-  //  }
-
-  gles2::CMesh::Indices dist_indices;
-  for (std::size_t i = 1; i < count; ++i)
+/// Brings the warp of @p output up to date with its key points, only the
+/// control net changes when the GPU evaluates the surface. Outputs without
+/// a distortion mesh get one.
+void updateOutputMesh(Output& output, const warp::MeshDensity& density)
+{
+  if (output.surface)
   {
-    for (std::size_t j = 0; j < count; ++j)
-    {
-      uint16_t x1 = (i - 1) * (count) + j;
-      uint16_t x2 = (i - 1) * (count) + j + count;
+    output.surface.emplace(output.key_points);
+  }
+  if (!output.dist_mesh)
+  {
+    output.dist_mesh.emplace(generateOutputMesh(
+        output.key_points,
+        density,
+        output.surface.has_value(),
+        &output.mesh_error));
+  }
+  else if (!output.surface)
+  {
+    warp::updateDistortionMesh(
+        *output.dist_mesh, density, output.key_points, &output.mesh_error);
+  }
+}
 
-      if (j == 0 && i != 1)
-      {
-        dist_indices.push_back(x1);
-      }
-      dist_indices.push_back(x1);
-      dist_indices.push_back(x2);
-    }
-    dist_indices.push_back(dist_indices.back());
+/// Re-reads the key points of @p output. Only the vertices are refreshed
+/// unless the grid or the blend mask changed, which rebuilds the output.
+/// On errors the output is left as it was. Returns whether the key points
+/// changed.
+bool reloadOutput(Output& output, const warp::MeshDensity& density)
+{
+  warp::KeyPoints loaded = warp::loadKeyPoints(output.kps_path);
+  if (loaded == output.key_points)
+  {
+    return false;
   }
+  const bool resized = loaded.size != output.key_points.size;
+  if (resized || loaded.blend.mask_path != output.key_points.blend.mask_path)
+  {
+    output = makeOutput(
+        output.kps_path,
+        std::move(loaded),
+        density,
+        output.surface.has_value());
+  }
+  else
+  {
+    output.key_points = std::move(loaded);
+    updateOutputMesh(output, density);
+    warp::updateKeyPointsMesh(output.kps_mesh, output.key_points);
+  }
+  return true;
+}
 
-  return gles2::CMesh(std::move(dist_vertices), std::move(dist_indices));
+/// Outputs split the window into equal columns, left to right.
+void setOutputViewport(const glm::ivec2& wnd_size, std::size_t index)
+{
+  const int left = static_cast<int>(wnd_size.x * index / g_num_outputs);
+  const int right =
+      static_cast<int>(wnd_size.x * (index + 1) / g_num_outputs);
+  glViewport(left, 0, right - left, wnd_size.y);
 }
 
-gles2::CMesh generateKeyPointsMesh(std::array<glm::vec2, 16> kps_mesh)
+void writeProfile(const app::CFrameProfiler& profiler, const std::string& path)
 {
-  gles2::CMesh::Vertices dist_vertices;
-  for (std::size_t i = 0; i < kps_mesh.size(); ++i)
+  std::ofstream file(path);
+  profiler.write(file);
+  if (!file)
   {
-    dist_vertices.push_back(
-        {glm::vec3(std::move(kps_mesh[i]), 0.f), glm::vec2(0.f)});
+    std::cerr << "Couldn't write profile " << path << std::endl;
+    return;
   }
-
-  gles2::CMesh::Indices dist_indices = {
-      0, 4,  1, 5,  2,  6, 3, 7,  7, 4,  4,  8,  5,  9,
-      6, 10, 7, 11, 11, 8, 8, 12, 9, 13, 10, 14, 11, 15,
-  };
-  return gles2::CMesh(std::move(dist_vertices), std::move(dist_indices));
+  std::cout << "Profile written to " << path << std::endl;
 }
 
 std::string getCurrentDateTime()
@@ -399,35 +292,12 @@ std::string getCurrentDateTime()
   return ss.str();
 }
 
-void storeKeyPoints(
-    const std::array<glm::vec2, 16>& kps,
-    const std::string_view& filename)
-{
-  if (std::ofstream file(filename.data()); file)
-  {
-    for (auto&& p : kps)
-    {
-      file << p.x << " " << p.y << "\n";
-    }
-    std::cout << "Saved to " << std::quoted(filename.data()) << std::endl;
-  }
-}
-
-std::array<glm::vec2, 16> loadKeyPoints(const std::string_view& filename)
+void key_callback(GLFWwindow*, int key, int, int action, int)
 {
-  std::array<glm::vec2, 16> kps;
-  if (std::ifstream file(filename.data()); file)
+  if (action != GLFW_RELEASE)
   {
-    for (auto& p : kps)
-    {
-      file >> p.x >> p.y;
-    }
+    g_request_to_redraw = true;
   }
-  return kps;
-}
-
-void key_callback(GLFWwindow*, int key, int, int action, int)
-{
   if (g_enable_points)
   {
     for (auto[k, v] : c_shift_keys)
@@ -443,8 +313,9 @@ void key_callback(GLFWwindow*, int key, int, int action, int)
     {
       if (key == k && action == GLFW_PRESS)
       {
-        g_pnt_index += v.x * 4 + v.y;
-        g_pnt_index = glm::mod<float>(g_pnt_index, c_key_points.size());
+        g_pnt_index += v.x * g_grid_size.y + v.y;
+        g_pnt_index =
+            glm::mod<float>(g_pnt_index, g_grid_size.x * g_grid_size.y);
         std::cout << "Select point: " << g_pnt_index << std::endl;
       }
     }
@@ -456,7 +327,7 @@ void key_callback(GLFWwindow*, int key, int, int action, int)
       if (key == k && action == GLFW_PRESS)
       {
         g_image_index += v;
-        g_image_index = glm::mod<float>(g_image_index, c_image_paths.size());
+        g_image_index = glm::mod<float>(g_image_index, g_num_images);
         std::cout << "Select image: " << g_image_index << std::endl;
       }
     }
@@ -499,6 +370,21 @@ void key_callback(GLFWwindow*, int key, int, int action, int)
     std::cout << "Request to reload kps." << std::endl;
   }
 
+  if (key == c_print_stats_key && action == GLFW_PRESS)
+  {
+    g_request_to_print_stats = true;
+  }
+  if (key == c_dump_profile_key && action == GLFW_PRESS)
+  {
+    g_request_to_dump_profile = true;
+  }
+  if (key == c_next_output_key && action == GLFW_PRESS)
+  {
+    g_output_index = (g_output_index + 1) % g_num_outputs;
+    g_pnt_index = 0;
+    std::cout << "Select output: " << g_output_index << std::endl;
+  }
+
   if (key == c_close_wnd_key && action == GLFW_PRESS)
   {
     g_request_to_stop_wnd = true;
@@ -510,6 +396,44 @@ void key_callback(GLFWwindow*, int key, int, int action, int)
 
 int main(int argc, const char** argv)
 {
+  app::Options opts;
+  try
+  {
+    opts = app::parseOptions(argc, argv);
+  }
+  catch (const app::OptionsError& e)
+  {
+    std::cerr << e.what() << std::endl;
+    app::printUsage(std::cerr, argv[0]);
+    return EXIT_FAILURE;
+  }
+  gles2::setProgramCacheDir(opts.shader_cache_dir);
+
+  if (opts.mode == app::Options::Mode::Headless)
+  {
+    try
+    {
+      return app::runHeadless(opts);
+    }
+    catch (const std::runtime_error& e)
+    {
+      std::cerr << "Headless warp failed: " << e.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (opts.mode == app::Options::Mode::ExportLut)
+  {
+    try
+    {
+      return app::runExportLut(opts);
+    }
+    catch (const std::runtime_error& e)
+    {
+      std::cerr << "LUT export failed: " << e.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   glfwSetErrorCallback([](int err, const char* msg) {
     std::cerr << "(" << std::hex << err << ") " << msg << std::endl;
   });
@@ -525,8 +449,19 @@ int main(int argc, const char** argv)
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
   glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
 
+  std::vector<std::string> kps_paths = {opts.kps_path};
+  kps_paths.insert(
+      kps_paths.end(),
+      opts.output_kps_paths.begin(),
+      opts.output_kps_paths.end());
+  g_num_outputs = kps_paths.size();
+
   GLFWwindow* window = glfwCreateWindow(
-      c_wnd_size.x, c_wnd_size.y, c_wnd_title, nullptr, nullptr);
+      c_wnd_size.x * static_cast<int>(g_num_outputs),
+      c_wnd_size.y,
+      c_wnd_title,
+      nullptr,
+      nullptr);
 
   if (nullptr == window)
   {
@@ -535,100 +470,587 @@ int main(int argc, const char** argv)
     return EXIT_FAILURE;
   }
 
-  std::array key_points = (argc == 2) ? loadKeyPoints(argv[1]) : c_key_points;
+  std::vector<warp::KeyPoints> initial_key_points;
+  for (auto&& path : kps_paths)
+  {
+    initial_key_points.push_back(warp::makeDefaultKeyPoints(opts.grid_size));
+    if (!path.empty())
+    {
+      try
+      {
+        initial_key_points.back() = warp::loadKeyPoints(path);
+      }
+      catch (const warp::KeyPointsLoadError&)
+      {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::vector<std::string> image_paths(
+      c_image_paths.begin(), c_image_paths.end());
+  if (!opts.image_paths.empty())
+  {
+    image_paths = opts.image_paths;
+  }
 
   glfwSetInputMode(window, GLFW_STICKY_KEYS, GL_TRUE);
   glfwSetKeyCallback(window, key_callback);
+  glfwSetWindowRefreshCallback(
+      window, [](GLFWwindow*) { g_request_to_redraw = true; });
+  glfwSetFramebufferSizeCallback(
+      window, [](GLFWwindow*, int, int) { g_request_to_redraw = true; });
 
   glfwMakeContextCurrent(window);
+  if (opts.swap_interval)
+  {
+    glfwSwapInterval(*opts.swap_interval);
+  }
   {
-    std::vector<gles2::CTexture2D> images;
-    for (auto&& path : c_image_paths)
+    // A stream replaces the still images, frames are shown as they arrive
+    std::optional<video::CVideoStream> stream;
+    std::optional<video::CFrameUploader> uploader;
+    if (!opts.stream_path.empty())
     {
-      images.push_back(gles2::CTexture2D::load(path));
+      try
+      {
+        stream.emplace(
+            video::CFrameReader(
+                opts.stream_path,
+                opts.stream_size,
+                opts.stream_fps,
+                opts.stream_format),
+            true);
+        uploader.emplace(stream->format());
+      }
+      catch (const video::StreamError& e)
+      {
+        stream.reset();
+        std::cerr << e.what() << std::endl;
+        std::cerr << "Fall back to still images." << std::endl;
+      }
     }
 
-    gles2::CMesh dist_mesh = generateDistortionMesh(c_num_points, key_points);
-    gles2::CMesh kps_mesh = generateKeyPointsMesh(key_points);
+    // Content rendered every frame into an offscreen source
+    std::optional<app::CTestPattern> pattern;
+    gles2::CRenderTarget pattern_target;
+    if (opts.pattern_size.x)
+    {
+      pattern.emplace();
+    }
+
+    // Images are loaded once selected, long playlists start right away.
+    // The one shown before stays until the selected one is decoded.
+    std::optional<app::CImageCache> images;
+    if (!stream && !pattern)
+    {
+      images.emplace(
+          image_paths, opts.texture_budget, opts.mipmaps, glfwPostEmptyEvent);
+    }
+    g_num_images = images ? std::max<std::size_t>(images->size(), 1) : 1;
+    const video::PixelFormat source_format =
+        uploader ? uploader->format().pixel_format : video::PixelFormat::Rgba;
+
+    // Every output warps the same source textures, adaptive meshes are
+    // tessellated for the size of an output column
+    warp::MeshDensity density{
+        opts.num_points, opts.tolerance, glm::uvec2(c_wnd_size)};
+    bool gpu_surface = opts.gpu_surface;
+    for (const warp::KeyPoints& key_points : initial_key_points)
+    {
+      if (gpu_surface && !warp::canEvaluateSurface(key_points.size))
+      {
+        std::cerr << "Grid is too big for the surface shaders, evaluate it "
+                     "on the CPU."
+                  << std::endl;
+        gpu_surface = false;
+      }
+    }
+    std::vector<Output> outputs;
+    for (std::size_t i = 0; i < kps_paths.size(); ++i)
+    {
+      outputs.push_back(makeOutput(
+          kps_paths[i],
+          std::move(initial_key_points[i]),
+          density,
+          gpu_surface,
+          !opts.lut_path.empty()));
+    }
 
-    gles2::CShaderProgram pts_program(c_dbg_vshader_src, c_dbg_fshader_src);
-    gles2::CShaderProgram img_program(c_img_vshader_src, c_img_fshader_src);
+    // The programs of the window are built together
+    const std::string img_fshader =
+        video::sourceFragmentShader(source_format, warp::c_img_fshader_src);
+    const std::string lut_fshader =
+        video::sourceFragmentShader(source_format, warp::c_lut_fshader_src);
+    const std::string surface_vshader =
+        gpu_surface ? warp::surfaceVertexShader() : std::string();
+    const std::string_view img_vshader =
+        gpu_surface ? std::string_view(surface_vshader)
+                    : std::string_view(warp::c_img_vshader_src);
+    std::vector<gles2::CShaderProgram::Sources> sources = {
+        {warp::c_dbg_vshader_src, warp::c_dbg_fshader_src},
+        {img_vshader, img_fshader},
+    };
+    if (!opts.lut_path.empty())
+    {
+      sources.push_back({warp::c_img_vshader_src, lut_fshader});
+    }
+    if (gpu_surface)
+    {
+      sources.push_back({surface_vshader, warp::c_dbg_fshader_src});
+    }
+    std::vector<gles2::CShaderProgram> programs =
+        gles2::CShaderProgram::build(sources, opts.parallel_compile);
+    gles2::CShaderProgram& pts_program = programs[0];
+    gles2::CShaderProgram& img_program = programs[1];
+    // Points of the distortion mesh, the surface shaders position them too
+    gles2::CShaderProgram& dist_pts_program =
+        gpu_surface ? programs.back() : pts_program;
+
+    const auto pts_mvp = pts_program.uniform<glm::mat4>("u_mvp");
+    const auto pts_size = pts_program.uniform<float>("u_pnt_sz");
+    const auto pts_color = pts_program.uniform<glm::vec4>("u_col");
+    const auto dist_pts_mvp = dist_pts_program.uniform<glm::mat4>("u_mvp");
+    const auto dist_pts_size = dist_pts_program.uniform<float>("u_pnt_sz");
+    const auto dist_pts_color = dist_pts_program.uniform<glm::vec4>("u_col");
+    const auto img_mvp = img_program.uniform<glm::mat4>("u_mvp");
+
+    // A baked LUT warps the only output until its key points change
+    std::optional<warp::CLutFile> lut;
+    std::optional<gles2::CTexture2D> lut_texture;
+    std::optional<gles2::CShaderProgram> lut_program;
+    gles2::CMesh quad_mesh = warp::generateQuadMesh();
+    if (!opts.lut_path.empty())
+    {
+      try
+      {
+        lut.emplace(opts.lut_path);
+        lut_texture.emplace(lut->upload());
+        lut_program.emplace(std::move(programs[2]));
+      }
+      catch (const warp::LutError&)
+      {
+        std::cerr << "Fall back to the distortion mesh." << std::endl;
+        for (Output& output : outputs)
+        {
+          updateOutputMesh(output, density);
+        }
+      }
+    }
+    // Without --kps the key points behind the LUT are the default grid, an
+    // edit would replace the calibrated warp with next to no warp
+    const bool lut_locked = lut_texture && outputs.front().kps_path.empty();
+    const auto drop_lut = [&](std::size_t index) {
+      if (lut_texture && index == 0)
+      {
+        std::cout << "Key points changed, drop baked LUT." << std::endl;
+        lut_texture.reset();
+      }
+    };
 
-    glEnable(GL_BLEND);
+    gles2::CStateCache::current().enable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glBlendEquation(GL_FUNC_ADD);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
+    // Main loop phases, draws are timed per output
+    app::CFrameProfiler profiler(!opts.profile_path.empty());
+    const auto poll_phase = profiler.phase("poll", false);
+    const auto mesh_phase = profiler.phase("mesh");
+    const auto upload_phase = profiler.phase("upload");
+    const auto pattern_phase = profiler.phase("pattern");
+    std::vector<app::CFrameProfiler::PhaseId> warp_phases;
+    std::vector<app::CFrameProfiler::PhaseId> points_phases;
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+      warp_phases.push_back(profiler.phase("warp_" + std::to_string(i)));
+      points_phases.push_back(profiler.phase("points_" + std::to_string(i)));
+    }
+    const auto swap_phase = profiler.phase("swap", false);
+    if (profiler.enabled() && !profiler.gpuTimed())
+    {
+      std::cout << "No GPU timer queries, profiling CPU time only."
+                << std::endl;
+    }
+
+    // Files rewritten by a calibration tool are applied on the next frame
+    std::optional<app::CFileWatcher> watcher;
+    std::vector<std::size_t> watched_outputs;
+    if (opts.watch)
+    {
+      std::vector<std::string> watched_paths;
+      for (std::size_t i = 0; i < outputs.size(); ++i)
+      {
+        if (!outputs[i].kps_path.empty())
+        {
+          watched_outputs.push_back(i);
+          watched_paths.push_back(outputs[i].kps_path);
+        }
+      }
+      try
+      {
+        watcher.emplace(watched_paths, glfwPostEmptyEvent);
+      }
+      catch (const app::FileWatchError& e)
+      {
+        std::cerr << e.what() << std::endl;
+      }
+    }
+
+    // On demand, the loop sleeps in the event queue while nothing changes,
+    // a stream wakes it up often enough to catch its frames
+    const bool on_demand = opts.redraw == app::Options::Redraw::OnDemand;
+    const double stream_wait =
+        stream && stream->format().fps > 0. ? .5 / stream->format().fps : .005;
+    const auto min_frame_time =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(
+                opts.max_fps > 0. ? 1. / opts.max_fps : 0.));
+    auto next_frame = std::chrono::steady_clock::now();
+
     while (!glfwWindowShouldClose(window))
     {
-      glfwPollEvents();
+      profiler.beginFrame();
+      profiler.begin(poll_phase);
+      if (on_demand && !g_request_to_redraw)
+      {
+        if (stream)
+        {
+          glfwWaitEventsTimeout(stream_wait);
+        }
+        else
+        {
+          glfwWaitEvents();
+        }
+      }
+      else
+      {
+        glfwPollEvents();
+      }
+      profiler.end();
 
       if (g_request_to_stop_wnd)
       {
         break;
       }
+
+      if (density.adaptive())
+      {
+        glm::ivec2 wnd_size;
+        glfwGetWindowSize(window, &wnd_size.x, &wnd_size.y);
+        const glm::uvec2 viewport(wnd_size.x / g_num_outputs, wnd_size.y);
+        if (viewport.x && viewport.y && viewport != density.viewport)
+        {
+          density.viewport = viewport;
+          profiler.begin(mesh_phase);
+          for (Output& output : outputs)
+          {
+            if (output.dist_mesh)
+            {
+              warp::updateDistortionMesh(
+                  *output.dist_mesh,
+                  density,
+                  output.key_points,
+                  &output.mesh_error);
+            }
+          }
+          profiler.end();
+          g_request_to_redraw = true;
+        }
+      }
+
+      // Editing keys act on the selected output only
+      Output& active = outputs[g_output_index];
+      warp::KeyPoints& key_points = active.key_points;
+      g_grid_size = glm::ivec2(key_points.size);
+
+      if ((g_request_to_reset_kps || g_request_to_update_mesh) && lut_locked)
+      {
+        std::cout << "Key points of the baked LUT are unknown, pass --kps to "
+                     "edit them."
+                  << std::endl;
+        g_request_to_reset_kps = false;
+        g_request_to_update_mesh = false;
+        g_shift = glm::vec2(0.f);
+      }
       if (g_request_to_reset_kps)
       {
-        key_points = c_key_points;
+        key_points.points = warp::makeDefaultKeyPoints(key_points.size).points;
         g_request_to_reset_kps = false;
         g_request_to_update_mesh = true;
       }
       if (g_request_to_reload_kps)
       {
-        if (argc == 2)
+        try
+        {
+          const glm::uvec2 size = active.key_points.size;
+          if (!active.kps_path.empty() && reloadOutput(active, density))
+          {
+            drop_lut(g_output_index);
+            if (active.key_points.size != size)
+            {
+              g_grid_size = glm::ivec2(active.key_points.size);
+              g_pnt_index = 0;
+            }
+          }
+        }
+        catch (const std::runtime_error&)
         {
-          key_points = loadKeyPoints(argv[1]);
+          std::cerr << "Keep current key points." << std::endl;
+        }
+        catch (const std::invalid_argument& e)
+        {
+          std::cerr << e.what() << ", keep current key points." << std::endl;
         }
         g_request_to_reload_kps = false;
-        g_request_to_update_mesh = true;
+      }
+      for (std::size_t index : watcher ? watcher->takeChanged()
+                                       : std::vector<std::size_t>())
+      {
+        const std::size_t i = watched_outputs[index];
+        std::cout << "Reload changed " << outputs[i].kps_path << std::endl;
+        try
+        {
+          const glm::uvec2 size = outputs[i].key_points.size;
+          if (reloadOutput(outputs[i], density))
+          {
+            drop_lut(i);
+            if (i == g_output_index && outputs[i].key_points.size != size)
+            {
+              g_grid_size = glm::ivec2(outputs[i].key_points.size);
+              g_pnt_index = 0;
+            }
+          }
+        }
+        catch (const std::runtime_error&)
+        {
+          std::cerr << "Keep current key points." << std::endl;
+        }
+        catch (const std::invalid_argument& e)
+        {
+          std::cerr << e.what() << ", keep current key points." << std::endl;
+        }
+        g_request_to_redraw = true;
       }
       if (g_request_to_update_mesh)
       {
+        drop_lut(g_output_index);
         key_points[g_pnt_index] += g_shift;
-        dist_mesh = generateDistortionMesh(c_num_points, key_points);
-        kps_mesh = generateKeyPointsMesh(key_points);
+        g_shift = glm::vec2(0.f);
+        profiler.begin(mesh_phase);
+        updateOutputMesh(active, density);
+        warp::updateKeyPointsMesh(active.kps_mesh, key_points);
+        profiler.end();
         g_request_to_update_mesh = false;
       }
+      if (g_request_to_print_stats)
+      {
+        const auto& counters = gles2::CStateCache::current().counters();
+        std::cout << "GL state changes last frame: " << counters.issued
+                  << " issued, " << counters.elided << " elided" << std::endl;
+        if (stream)
+        {
+          const auto stats = stream->stats();
+          std::cout << "Stream: " << stats.read << " shown, " << stats.dropped
+                    << " dropped, queue depth " << stats.mean_depth
+                    << " mean " << stats.max_depth << " max" << std::endl;
+        }
+        if (active.dist_mesh)
+        {
+          std::cout << "Mesh: " << active.dist_mesh->getVertices().size()
+                    << " vertices";
+        }
+        else
+        {
+          std::cout << "Mesh: none, warped by the baked LUT";
+        }
+        if (active.dist_mesh && density.adaptive())
+        {
+          std::cout << ", max error " << active.mesh_error << " px of "
+                    << density.tolerance;
+        }
+        std::cout << std::endl;
+        if (images)
+        {
+          const auto& stats = images->stats();
+          std::cout << "Images: " << stats.resident << " of " << images->size()
+                    << " resident, " << (stats.resident_bytes >> 20)
+                    << " MiB, " << stats.uploads << " uploads, "
+                    << stats.evictions << " evictions" << std::endl;
+        }
+        g_request_to_print_stats = false;
+      }
+      if (g_request_to_dump_profile)
+      {
+        if (profiler.enabled())
+        {
+          writeProfile(profiler, opts.profile_path);
+        }
+        g_request_to_dump_profile = false;
+      }
+      gles2::CStateCache::current().resetCounters();
+
       if (g_request_to_save_kps)
       {
-        std::string filename = getCurrentDateTime() + ".hcd";
-        storeKeyPoints(key_points, filename);
+        std::string filename = getCurrentDateTime();
+        if (outputs.size() > 1)
+        {
+          filename += "_" + std::to_string(g_output_index);
+        }
+        warp::storeKeyPoints(key_points, filename + ".hcd");
         g_request_to_save_kps = false;
       }
 
+      if (stream)
+      {
+        if (const video::Frame* frame = stream->acquire(true))
+        {
+          profiler.begin(upload_phase);
+          uploader->upload(*frame);
+          profiler.end();
+          stream->release();
+          g_request_to_redraw = true;
+        }
+      }
+      if (images && images->selectedDecoded())
+      {
+        g_request_to_redraw = true;
+      }
+      if (on_demand && !g_request_to_redraw)
+      {
+        continue;
+      }
+      g_request_to_redraw = false;
+      auto bind_source = [&](gles2::CShaderProgram& program) {
+        video::setSourceUniforms(program, opts.yuv_matrix);
+        if (uploader)
+        {
+          uploader->bind();
+        }
+        else if (pattern)
+        {
+          gles2::CTexture2D::bind(pattern_target.texture());
+        }
+        else if (auto image = images->get(g_image_index))
+        {
+          gles2::CTexture2D::bind(*image);
+        }
+        else
+        {
+          gles2::CTexture2D::unbind();
+        }
+      };
+      auto bind_blend = [](gles2::CShaderProgram& program, Output& output) {
+        warp::setEdgeBlendUniforms(
+            program, output.key_points.blend, output.mask.has_value());
+        if (output.mask)
+        {
+          gles2::CTexture2D::bind(*output.mask, warp::c_blend_mask_unit);
+        }
+      };
+
+      if (pattern)
+      {
+        profiler.begin(pattern_phase);
+        pattern->render(pattern_target, opts.pattern_size);
+        gles2::CFrameBuffer::unbind();
+        profiler.end();
+      }
+
       glClear(GL_COLOR_BUFFER_BIT);
 
       glm::ivec2 wnd_size;
       glfwGetWindowSize(window, &wnd_size.x, &wnd_size.y);
-      glViewport(0, 0, wnd_size.x, wnd_size.y);
 
-      if (g_enable_image)
+      for (std::size_t i = 0; i < outputs.size(); ++i)
       {
-        gles2::CShaderProgram::use(img_program);
-        img_program.setUniform("u_mvp", glm::scale(glm::vec3(g_img_zoom)));
-        gles2::CTexture2D::bind(images[g_image_index]);
-        dist_mesh.draw(img_program);
-      }
+        Output& output = outputs[i];
+        setOutputViewport(wnd_size, i);
 
-      if (g_enable_points)
-      {
-        gles2::CShaderProgram::use(pts_program);
-        pts_program.setUniform("u_mvp", glm::scale(glm::vec3(g_img_zoom)));
+        if (g_enable_image && lut_texture)
+        {
+          profiler.begin(warp_phases[i]);
+          gles2::CShaderProgram::use(*lut_program);
+          lut_program->setUniform(
+              "u_mvp", glm::scale(glm::vec3(g_img_zoom)));
+          lut_program->setUniform("u_lut", 1);
+          lut_program->setUniform(
+              "u_lut_scale", static_cast<float>(lut->header().uv_scale));
+          bind_source(*lut_program);
+          bind_blend(*lut_program, output);
+          gles2::CTexture2D::bind(*lut_texture, 1);
+          quad_mesh.draw(*lut_program);
+          profiler.end();
+        }
+        else if (g_enable_image)
+        {
+          profiler.begin(warp_phases[i]);
+          gles2::CShaderProgram::use(img_program);
+          img_program.setUniform(img_mvp, glm::scale(glm::vec3(g_img_zoom)));
+          bind_source(img_program);
+          bind_blend(img_program, output);
+          if (output.surface)
+          {
+            warp::setSurfaceUniforms(img_program, *output.surface);
+          }
+          output.dist_mesh->draw(img_program);
+          profiler.end();
+        }
 
-        pts_program.setUniform("u_pnt_sz", 20.f);
-        pts_program.setUniform("u_col", glm::vec4(1.f, 1.f, 0.f, .7f));
-        kps_mesh.draw(pts_program, {static_cast<uint16_t>(g_pnt_index)}, true);
+        if (g_enable_points)
+        {
+          profiler.begin(points_phases[i]);
+          gles2::CShaderProgram::use(pts_program);
+          pts_program.setUniform(pts_mvp, glm::scale(glm::vec3(g_img_zoom)));
+
+          if (i == g_output_index)
+          {
+            pts_program.setUniform(pts_size, 20.f);
+            pts_program.setUniform(pts_color, glm::vec4(1.f, 1.f, 0.f, .7f));
+            output.kps_mesh.draw(
+                pts_program, {static_cast<uint32_t>(g_pnt_index)}, true);
+          }
+
+          pts_program.setUniform(pts_size, 10.f);
+          pts_program.setUniform(pts_color, glm::vec4(1.f, 0.f, 1.f, .7f));
+          output.kps_mesh.draw(pts_program, true);
+
+          gles2::CShaderProgram::use(dist_pts_program);
+          dist_pts_program.setUniform(
+              dist_pts_mvp, glm::scale(glm::vec3(g_img_zoom)));
+          dist_pts_program.setUniform(dist_pts_size, 2.f);
+          dist_pts_program.setUniform(
+              dist_pts_color, glm::vec4(0.f, 1.f, 1.f, .7f));
+          if (output.surface)
+          {
+            warp::setSurfaceUniforms(dist_pts_program, *output.surface);
+          }
+          if (output.dist_mesh)
+          {
+            output.dist_mesh->draw(dist_pts_program, true);
+          }
+          profiler.end();
+        }
+      }
 
-        pts_program.setUniform("u_pnt_sz", 10.f);
-        pts_program.setUniform("u_col", glm::vec4(1.f, 0.f, 1.f, .7f));
-        kps_mesh.draw(pts_program, true);
+      profiler.begin(swap_phase);
+      glfwSwapBuffers(window);
+      profiler.end();
+      profiler.endFrame();
 
-        pts_program.setUniform("u_pnt_sz", 2.f);
-        pts_program.setUniform("u_col", glm::vec4(0.f, 1.f, 1.f, .7f));
-        dist_mesh.draw(pts_program, true);
+      if (opts.max_fps > 0.)
+      {
+        next_frame = std::max(
+            next_frame + min_frame_time, std::chrono::steady_clock::now());
+        std::this_thread::sleep_until(next_frame);
       }
+    }
 
-      glfwSwapBuffers(window);
+    if (profiler.enabled())
+    {
+      writeProfile(profiler, opts.profile_path);
     }
   }
 
@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CFrameReader.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace video {
+
+namespace {
+
+int closeFile(std::FILE* file)
+{
+  return (file == stdin) ? 0 : std::fclose(file);
+}
+
+std::string readLine(std::FILE* file)
+{
+  std::string line;
+  for (int c; (c = std::fgetc(file)) != EOF && c != '\n';)
+  {
+    line.push_back(static_cast<char>(c));
+  }
+  return line;
+}
+
+} // namespace
+
+CFrameReader::CFrameReader(
+    const std::string& path,
+    const glm::uvec2& raw_size,
+    double raw_fps,
+    PixelFormat raw_format)
+  : m_file(
+        (path == "-") ? stdin : std::fopen(path.c_str(), "rb"),
+        &closeFile)
+  , m_format{raw_size, raw_format, raw_fps}
+  , m_y4m(0 == raw_size.x)
+{
+  if (!m_file)
+  {
+    std::cerr << "Couldn't open stream " << path << std::endl;
+    throw StreamError("open error");
+  }
+  if (m_y4m)
+  {
+    readY4mHeader();
+  }
+}
+
+void CFrameReader::readY4mHeader()
+{
+  std::istringstream header(readLine(m_file.get()));
+  std::string token;
+  header >> token;
+  if (token != "YUV4MPEG2")
+  {
+    std::cerr << "Stream is neither Y4M nor given a raw size" << std::endl;
+    throw StreamError("unknown stream format");
+  }
+
+  m_format.pixel_format = PixelFormat::I420;
+  while (header >> token)
+  {
+    const std::string value = token.substr(1);
+    switch (token[0])
+    {
+    case 'W':
+      m_format.size.x = std::strtoul(value.c_str(), nullptr, 10);
+      break;
+    case 'H':
+      m_format.size.y = std::strtoul(value.c_str(), nullptr, 10);
+      break;
+    case 'F':
+      if (unsigned num = 0, den = 0;
+          std::sscanf(value.c_str(), "%u:%u", &num, &den) == 2 && den)
+      {
+        m_format.fps = static_cast<double>(num) / den;
+      }
+      break;
+    case 'C':
+      if (value.compare(0, 3, "420") != 0)
+      {
+        std::cerr << "Unsupported Y4M colorspace " << value << std::endl;
+        throw StreamError("unsupported colorspace");
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (0 == m_format.size.x || 0 == m_format.size.y)
+  {
+    throw StreamError("Y4M header without frame size");
+  }
+}
+
+bool CFrameReader::readPlane(
+    uint8_t* plane,
+    const glm::uvec2& size,
+    std::size_t bpp)
+{
+  const std::size_t stride = size.x * bpp;
+  for (std::size_t y = size.y; y-- > 0;)
+  {
+    if (std::fread(plane + y * stride, 1, stride, m_file.get()) != stride)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CFrameReader::read(uint8_t* pixels)
+{
+  if (m_y4m)
+  {
+    const std::string header = readLine(m_file.get());
+    if (header.empty() && std::feof(m_file.get()))
+    {
+      return false;
+    }
+    if (header.compare(0, 5, "FRAME") != 0)
+    {
+      throw StreamError("bad Y4M frame header");
+    }
+  }
+
+  const glm::uvec2 chroma_size = chromaSize(m_format.size);
+  uint8_t* chroma = pixels + std::size_t{m_format.size.x} * m_format.size.y;
+  switch (m_format.pixel_format)
+  {
+  case PixelFormat::Rgba:
+    return readPlane(pixels, m_format.size, 4);
+  case PixelFormat::I420:
+    return readPlane(pixels, m_format.size, 1) &&
+           readPlane(chroma, chroma_size, 1) &&
+           readPlane(
+               chroma + std::size_t{chroma_size.x} * chroma_size.y,
+               chroma_size,
+               1);
+  case PixelFormat::Nv12:
+    return readPlane(pixels, m_format.size, 1) &&
+           readPlane(chroma, chroma_size, 2);
+  }
+  return false;
+}
+
+} // namespace video
@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "Frame.hpp"
+
+namespace video {
+
+/// Reads uncompressed frames from a file, or from stdin for "-".
+///
+/// Without a raw size the input has to be a YUV4MPEG2 stream with 4:2:0
+/// frames, otherwise it is headerless frames of that size and format.
+/// Rows of every plane are flipped while reading, so frames come out
+/// bottom-up.
+class CFrameReader
+{
+public:
+  explicit CFrameReader(
+      const std::string& path,
+      const glm::uvec2& raw_size = {0u, 0u},
+      double raw_fps = 0.,
+      PixelFormat raw_format = PixelFormat::Rgba);
+
+  const FrameFormat& format() const { return m_format; }
+
+  /// Fills frameBytes(format()) bytes at @p pixels, returns false at the
+  /// end of the stream.
+  bool read(uint8_t* pixels);
+
+private:
+  void readY4mHeader();
+  bool readPlane(uint8_t* plane, const glm::uvec2& size, std::size_t bpp);
+
+  std::unique_ptr<std::FILE, int (*)(std::FILE*)> m_file;
+  FrameFormat m_format;
+  bool m_y4m;
+};
+
+} // namespace video
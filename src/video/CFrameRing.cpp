@@ -0,0 +1,125 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CFrameRing.hpp"
+
+#include <algorithm>
+
+namespace video {
+
+CFrameRing::CFrameRing(std::size_t capacity, std::size_t frame_bytes)
+  : m_slots(std::max<std::size_t>(capacity, 2))
+{
+  for (auto& slot : m_slots)
+  {
+    slot.pixels.resize(frame_bytes);
+  }
+}
+
+Frame* CFrameRing::beginWrite()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_count == m_slots.size() && !m_closed)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    m_can_write.wait(
+        lock, [this] { return m_count < m_slots.size() || m_closed; });
+    m_stats.producer_wait += std::chrono::steady_clock::now() - start;
+  }
+  if (m_closed)
+  {
+    return nullptr;
+  }
+  return &m_slots[(m_head + m_count) % m_slots.size()];
+}
+
+void CFrameRing::endWrite()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_count;
+    ++m_stats.written;
+    m_stats.max_depth = std::max(m_stats.max_depth, m_count);
+  }
+  m_can_read.notify_one();
+}
+
+Frame* CFrameRing::beginRead(bool latest, bool wait)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (wait)
+  {
+    m_can_read.wait(lock, [this] { return m_count > 0 || m_closed; });
+  }
+  if (0 == m_count)
+  {
+    return nullptr;
+  }
+
+  m_depth_sum += m_count;
+  ++m_depth_samples;
+  if (latest && m_count > 1)
+  {
+    const std::size_t skipped = m_count - 1;
+    m_head = (m_head + skipped) % m_slots.size();
+    m_count -= skipped;
+    m_stats.dropped += skipped;
+    m_can_write.notify_one();
+  }
+  return &m_slots[m_head];
+}
+
+void CFrameRing::endRead()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_head = (m_head + 1) % m_slots.size();
+    --m_count;
+    ++m_stats.read;
+  }
+  m_can_write.notify_one();
+}
+
+void CFrameRing::close()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+  }
+  m_can_write.notify_all();
+  m_can_read.notify_all();
+}
+
+CFrameRing::Stats CFrameRing::stats() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Stats stats = m_stats;
+  if (m_depth_samples)
+  {
+    stats.mean_depth = static_cast<double>(m_depth_sum) / m_depth_samples;
+  }
+  return stats;
+}
+
+} // namespace video
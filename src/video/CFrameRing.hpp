@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "Frame.hpp"
+
+namespace video {
+
+/// Bounded single producer, single consumer queue of preallocated frames.
+///
+/// Slots are handed out in place, so neither side copies or allocates
+/// pixels. A slot stays owned by its side between begin and end calls.
+class CFrameRing
+{
+public:
+  struct Stats
+  {
+    uint64_t written = 0;
+    uint64_t read = 0;
+    uint64_t dropped = 0;
+    std::size_t max_depth = 0;
+    double mean_depth = 0.;
+    std::chrono::duration<double> producer_wait{0.};
+  };
+
+  CFrameRing(std::size_t capacity, std::size_t frame_bytes);
+
+  /// Blocks while the ring is full, returns nullptr once closed.
+  Frame* beginWrite();
+  void endWrite();
+
+  /// Oldest queued frame, or with @p latest the newest one, dropping the
+  /// frames queued before it. Returns nullptr when empty, unless @p wait
+  /// is set, then it blocks until a frame arrives or the ring is closed.
+  Frame* beginRead(bool latest, bool wait = false);
+  void endRead();
+
+  /// Wakes both sides, writes are refused while queued frames stay
+  /// readable.
+  void close();
+
+  Stats stats() const;
+
+private:
+  mutable std::mutex m_mutex;
+  std::condition_variable m_can_write;
+  std::condition_variable m_can_read;
+  std::vector<Frame> m_slots;
+  std::size_t m_head = 0;
+  std::size_t m_count = 0;
+  bool m_closed = false;
+  Stats m_stats;
+  uint64_t m_depth_sum = 0;
+  uint64_t m_depth_samples = 0;
+};
+
+} // namespace video
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CFrameUploader.hpp"
+
+namespace video {
+
+namespace {
+
+std::vector<gles2::CTexture2D> makePlanes(const FrameFormat& format)
+{
+  const glm::uvec2 chroma_size = chromaSize(format.size);
+  std::vector<gles2::CTexture2D> planes;
+  switch (format.pixel_format)
+  {
+  case PixelFormat::Rgba:
+    planes.emplace_back(format.size, GL_RGBA);
+    break;
+  case PixelFormat::I420:
+    planes.emplace_back(format.size, GL_LUMINANCE);
+    planes.emplace_back(chroma_size, GL_LUMINANCE);
+    planes.emplace_back(chroma_size, GL_LUMINANCE);
+    break;
+  case PixelFormat::Nv12:
+    planes.emplace_back(format.size, GL_LUMINANCE);
+    planes.emplace_back(chroma_size, GL_LUMINANCE_ALPHA);
+    break;
+  }
+
+  // Chroma is filtered across the frame edges otherwise
+  for (gles2::CTexture2D& plane : planes)
+  {
+    plane.setWrap(GL_CLAMP_TO_EDGE);
+  }
+  return planes;
+}
+
+std::size_t bytesPerTexel(GLint format)
+{
+  switch (format)
+  {
+  case GL_LUMINANCE:
+    return 1;
+  case GL_LUMINANCE_ALPHA:
+    return 2;
+  case GL_RGB:
+    return 3;
+  default:
+    return 4;
+  }
+}
+
+} // namespace
+
+CFrameUploader::CFrameUploader(const FrameFormat& format)
+  : m_format(format)
+  , m_planes{makePlanes(format), makePlanes(format)}
+  , m_front(0)
+{
+}
+
+void CFrameUploader::upload(const Frame& frame)
+{
+  m_front = 1 - m_front;
+
+  // Planes are tightly packed, odd widths leave rows unaligned
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  const uint8_t* data = frame.pixels.data();
+  for (gles2::CTexture2D& plane : m_planes[m_front])
+  {
+    plane.update(data);
+    data += std::size_t{plane.size().x} * plane.size().y *
+            bytesPerTexel(plane.format());
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void CFrameUploader::bind() const
+{
+  const std::vector<gles2::CTexture2D>& planes = m_planes[m_front];
+  gles2::CTexture2D::bind(planes[0]);
+  for (std::size_t i = 1; i < planes.size(); ++i)
+  {
+    gles2::CTexture2D::bind(planes[i], c_chroma_unit + i - 1);
+  }
+}
+
+} // namespace video
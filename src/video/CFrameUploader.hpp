@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Frame.hpp"
+#include "gles2/CTexture2D.hpp"
+
+namespace video {
+
+/// Streams frames into a pair of texture sets allocated once. Each upload
+/// goes with glTexSubImage2D into the set the previous frame did not use,
+/// so it doesn't have to wait for draws still reading the other one.
+///
+/// YUV frames keep their planes: luma is a GL_LUMINANCE texture, chroma
+/// either two GL_LUMINANCE textures (I420) or one GL_LUMINANCE_ALPHA
+/// texture (NV12), converted by the shader from sourceShaderSource().
+class CFrameUploader
+{
+public:
+  /// Chroma planes are bound from this unit on, unit 1 is left for LUTs.
+  static constexpr std::size_t c_chroma_unit = 2;
+
+  explicit CFrameUploader(const FrameFormat& format);
+
+  void upload(const Frame& frame);
+
+  /// Binds the planes of the most recently uploaded frame, RGBA or luma
+  /// on unit 0 and chroma on c_chroma_unit and the next one.
+  void bind() const;
+
+  const FrameFormat& format() const { return m_format; }
+
+  /// RGBA or luma plane of the most recently uploaded frame.
+  const gles2::CTexture2D& texture() const { return m_planes[m_front][0]; }
+
+private:
+  FrameFormat m_format;
+  std::array<std::vector<gles2::CTexture2D>, 2> m_planes;
+  std::size_t m_front;
+};
+
+} // namespace video
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CVideoStream.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+namespace video {
+
+CVideoStream::CVideoStream(
+    CFrameReader reader,
+    bool realtime,
+    std::size_t queue_size)
+  : m_format(reader.format())
+  , m_ring(queue_size, frameBytes(m_format))
+  , m_thread(&CVideoStream::produce, this, std::move(reader), realtime)
+{
+}
+
+CVideoStream::~CVideoStream()
+{
+  m_ring.close();
+  m_thread.join();
+}
+
+const Frame* CVideoStream::acquire(bool latest, bool wait)
+{
+  return m_ring.beginRead(latest, wait);
+}
+
+void CVideoStream::release()
+{
+  m_ring.endRead();
+}
+
+void CVideoStream::produce(CFrameReader reader, bool realtime)
+{
+  using clock = std::chrono::steady_clock;
+  const bool paced = realtime && m_format.fps > 0.;
+  const std::chrono::duration<double> period(paced ? 1. / m_format.fps : 0.);
+  const auto start = clock::now();
+
+  try
+  {
+    for (uint64_t index = 0;; ++index)
+    {
+      Frame* frame = m_ring.beginWrite();
+      if (!frame || !reader.read(frame->pixels.data()))
+      {
+        break;
+      }
+      frame->index = index;
+
+      if (paced)
+      {
+        std::this_thread::sleep_until(
+            start + std::chrono::duration_cast<clock::duration>(
+                        period * static_cast<double>(index)));
+      }
+      m_ring.endWrite();
+    }
+  }
+  catch (const StreamError& e)
+  {
+    std::cerr << "Stream stopped: " << e.what() << std::endl;
+  }
+
+  m_finished = true;
+  m_ring.close();
+}
+
+} // namespace video
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+#include "CFrameReader.hpp"
+#include "CFrameRing.hpp"
+
+namespace video {
+
+/// Decodes a CFrameReader on its own thread into a CFrameRing.
+///
+/// With @p realtime the producer releases frames at the stream rate, as a
+/// camera or a player would; otherwise it reads as fast as the consumer
+/// takes them. Frames keep the pixel format of the reader.
+class CVideoStream
+{
+public:
+  explicit CVideoStream(
+      CFrameReader reader,
+      bool realtime,
+      std::size_t queue_size = 4);
+  CVideoStream(const CVideoStream&) = delete;
+  CVideoStream& operator=(const CVideoStream&) = delete;
+  ~CVideoStream();
+
+  const FrameFormat& format() const { return m_format; }
+  bool finished() const { return m_finished; }
+
+  /// See CFrameRing::beginRead(), every returned frame needs a release().
+  const Frame* acquire(bool latest, bool wait = false);
+  void release();
+
+  CFrameRing::Stats stats() const { return m_ring.stats(); }
+
+private:
+  void produce(CFrameReader reader, bool realtime);
+
+  FrameFormat m_format;
+  CFrameRing m_ring;
+  std::atomic<bool> m_finished{false};
+  std::thread m_thread;
+};
+
+} // namespace video
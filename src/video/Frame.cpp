@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "Frame.hpp"
+
+namespace video {
+
+glm::uvec2 chromaSize(const glm::uvec2& size)
+{
+  return (size + 1u) / 2u;
+}
+
+std::size_t frameBytes(const FrameFormat& format)
+{
+  const std::size_t luma = std::size_t{format.size.x} * format.size.y;
+  const glm::uvec2 chroma = chromaSize(format.size);
+  switch (format.pixel_format)
+  {
+  case PixelFormat::Rgba:
+    return 4 * luma;
+  case PixelFormat::I420:
+  case PixelFormat::Nv12:
+    return luma + 2 * std::size_t{chroma.x} * chroma.y;
+  }
+  return 0;
+}
+
+} // namespace video
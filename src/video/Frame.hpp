@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace video {
+
+struct StreamError : std::runtime_error
+{
+  using std::runtime_error::runtime_error;
+};
+
+enum class PixelFormat
+{
+  Rgba,
+  /// Y plane, then U and V planes of half width and height.
+  I420,
+  /// Y plane, then one half size plane of interleaved U and V.
+  Nv12,
+};
+
+/// Matrices from limited range YUV to RGB.
+enum class YuvMatrix
+{
+  Bt601,
+  Bt709,
+};
+
+struct FrameFormat
+{
+  glm::uvec2 size{0u, 0u};
+  PixelFormat pixel_format = PixelFormat::Rgba;
+  double fps = 0.;
+};
+
+/// Size of the 4:2:0 chroma planes, odd sizes round up.
+glm::uvec2 chromaSize(const glm::uvec2& size);
+
+/// Bytes of one tightly packed frame, chroma planes round up.
+std::size_t frameBytes(const FrameFormat& format);
+
+/// One decoded frame, rows go bottom-up as in GL.
+struct Frame
+{
+  std::vector<uint8_t> pixels;
+  uint64_t index = 0;
+};
+
+} // namespace video
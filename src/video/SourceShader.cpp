@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "SourceShader.hpp"
+
+#include <glm/vec3.hpp>
+
+#include "CFrameUploader.hpp"
+#include "warp/Shaders.hpp"
+
+namespace video {
+
+namespace {
+
+const char* sourceShaderSource(PixelFormat format)
+{
+  switch (format)
+  {
+  case PixelFormat::I420:
+    return warp::c_i420_source_src;
+  case PixelFormat::Nv12:
+    return warp::c_nv12_source_src;
+  case PixelFormat::Rgba:
+    break;
+  }
+  return warp::c_rgba_source_src;
+}
+
+} // namespace
+
+std::string sourceFragmentShader(
+    PixelFormat format,
+    const std::string_view& warp_fshader_src)
+{
+  std::string source = sourceShaderSource(format);
+  source.append(warp::c_blend_src);
+  source.append(warp_fshader_src);
+  return source;
+}
+
+void setSourceUniforms(gles2::CShaderProgram& program, YuvMatrix matrix)
+{
+  constexpr GLint chroma_unit = CFrameUploader::c_chroma_unit;
+  program.setUniform("u_tex", 0);
+  program.setUniform("u_tex_u", chroma_unit);
+  program.setUniform("u_tex_v", chroma_unit + 1);
+  program.setUniform("u_tex_uv", chroma_unit);
+  program.setUniform("u_yuv_matrix", yuvToRgbMatrix(matrix));
+  program.setUniform(
+      "u_yuv_offset", glm::vec3(16.f, 128.f, 128.f) / 255.f);
+}
+
+glm::mat3 yuvToRgbMatrix(YuvMatrix matrix)
+{
+  const float kr = (matrix == YuvMatrix::Bt709) ? .2126f : .299f;
+  const float kb = (matrix == YuvMatrix::Bt709) ? .0722f : .114f;
+  const float kg = 1.f - kr - kb;
+
+  // Luma spans 219 and chroma 224 of the 255 steps in limited range
+  const float ys = 255.f / 219.f;
+  const float cs = 255.f / 224.f;
+
+  // Columns multiply Y, U and V
+  return glm::mat3(
+      glm::vec3(ys),
+      glm::vec3(0.f, -cs * 2.f * kb * (1.f - kb) / kg, cs * 2.f * (1.f - kb)),
+      glm::vec3(cs * 2.f * (1.f - kr), -cs * 2.f * kr * (1.f - kr) / kg, 0.f));
+}
+
+} // namespace video
@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <glm/mat3x3.hpp>
+#include <string>
+#include <string_view>
+
+#include "Frame.hpp"
+#include "gles2/CShaderProgram.hpp"
+
+namespace video {
+
+/// Fragment shader of a warp, @p warp_fshader_src calls sampleSource(),
+/// which samples frames of @p format as bound by CFrameUploader::bind()
+/// and converts YUV to RGB in the same pass, and blendEdges(), set up by
+/// warp::setEdgeBlendUniforms().
+std::string sourceFragmentShader(
+    PixelFormat format,
+    const std::string_view& warp_fshader_src);
+
+/// Sets the samplers and the YUV matrix of a program built with
+/// sourceFragmentShader(), the program has to be in use.
+void setSourceUniforms(gles2::CShaderProgram& program, YuvMatrix matrix);
+
+/// Maps limited range YUV, offset by (16, 128, 128) / 255, to RGB.
+glm::mat3 yuvToRgbMatrix(YuvMatrix matrix);
+
+} // namespace video
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace warp {
+
+template <std::size_t N>
+struct BezierControlPoints
+{
+  std::array<float, N - 1> p1;
+  std::array<float, N - 1> p2;
+};
+
+/// Inner control points of the C2 continuous cubic Bezier spline going
+/// through @p knots, one coordinate at a time.
+/// https://www.particleincell.com/2012/bezier-splines/
+template <std::size_t N>
+constexpr BezierControlPoints<N> bezierControlPoints(
+    const std::array<float, N>& knots)
+{
+  static_assert(N >= 2, "spline needs at least two knots");
+  constexpr std::size_t num = N - 1;
+
+  /*rhs vector*/
+  std::array<float, num> a{};
+  std::array<float, num> b{};
+  std::array<float, num> c{};
+  std::array<float, num> r{};
+
+  /*left most segment*/
+  a[0] = 0;
+  b[0] = 2;
+  c[0] = 1;
+  r[0] = knots[0] + knots[1] * 2.f;
+
+  /*internal segments*/
+  for (std::size_t i = 1; i + 1 < num; ++i)
+  {
+    a[i] = 1;
+    b[i] = 4;
+    c[i] = 1;
+    r[i] = knots[i] * 4.f + knots[i + 1] * 2.f;
+  }
+
+  /*right segment*/
+  a[num - 1] = 2;
+  b[num - 1] = 7;
+  c[num - 1] = 0;
+  r[num - 1] = knots[num - 1] * 8.f + knots[num];
+
+  /*solves Ax=b with the Thomas algorithm (from Wikipedia)*/
+  for (std::size_t i = 1; i < num; ++i)
+  {
+    float m = a[i] / b[i - 1];
+    b[i] = b[i] - c[i - 1] * m;
+    r[i] = r[i] - r[i - 1] * m;
+  }
+
+  BezierControlPoints<N> cp{};
+  cp.p1[num - 1] = r[num - 1] / b[num - 1];
+  for (std::size_t i = num - 1; i-- > 0;)
+  {
+    cp.p1[i] = (r[i] - cp.p1[i + 1] * c[i]) / b[i];
+  }
+
+  /*we have p1, now compute p2*/
+  for (std::size_t i = 0; i + 1 < num; ++i)
+  {
+    cp.p2[i] = knots[i + 1] * 2.f - cp.p1[i + 1];
+  }
+  cp.p2[num - 1] = (knots[num] + cp.p1[num - 1]) * 0.5f;
+
+  return cp;
+}
+
+} // namespace warp
@@ -0,0 +1,104 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CBezierBasis.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace warp {
+
+CBezierBasis::CBezierBasis(std::size_t count)
+  : m_count(count)
+  , m_t(count)
+{
+  for (auto&& b : m_basis)
+  {
+    b.resize(count);
+  }
+
+  for (std::size_t k = 0; k < count; ++k)
+  {
+    const float t = (count > 1) ? static_cast<float>(k) / (count - 1) : 0.f;
+    const float s = 1.f - t;
+    m_t[k] = t;
+    m_basis[0][k] = s * s * s;
+    m_basis[1][k] = 3.f * t * s * s;
+    m_basis[2][k] = 3.f * t * t * s;
+    m_basis[3][k] = t * t * t;
+  }
+}
+
+void CBezierBasis::evaluate(
+    const glm::vec2& p0,
+    const glm::vec2& p1,
+    const glm::vec2& p2,
+    const glm::vec2& p3,
+    float* xs,
+    float* ys) const
+{
+  const float* b0 = m_basis[0].data();
+  const float* b1 = m_basis[1].data();
+  const float* b2 = m_basis[2].data();
+  const float* b3 = m_basis[3].data();
+
+  std::size_t k = 0;
+#if defined(__SSE2__)
+  const __m128 x0 = _mm_set1_ps(p0.x);
+  const __m128 x1 = _mm_set1_ps(p1.x);
+  const __m128 x2 = _mm_set1_ps(p2.x);
+  const __m128 x3 = _mm_set1_ps(p3.x);
+  const __m128 y0 = _mm_set1_ps(p0.y);
+  const __m128 y1 = _mm_set1_ps(p1.y);
+  const __m128 y2 = _mm_set1_ps(p2.y);
+  const __m128 y3 = _mm_set1_ps(p3.y);
+
+  for (; k + 4 <= m_count; k += 4)
+  {
+    const __m128 w0 = _mm_loadu_ps(b0 + k);
+    const __m128 w1 = _mm_loadu_ps(b1 + k);
+    const __m128 w2 = _mm_loadu_ps(b2 + k);
+    const __m128 w3 = _mm_loadu_ps(b3 + k);
+
+    const __m128 x = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(w0, x0), _mm_mul_ps(w1, x1)),
+        _mm_add_ps(_mm_mul_ps(w2, x2), _mm_mul_ps(w3, x3)));
+    const __m128 y = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(w0, y0), _mm_mul_ps(w1, y1)),
+        _mm_add_ps(_mm_mul_ps(w2, y2), _mm_mul_ps(w3, y3)));
+
+    _mm_storeu_ps(xs + k, x);
+    _mm_storeu_ps(ys + k, y);
+  }
+#endif
+
+  for (; k < m_count; ++k)
+  {
+    xs[k] = b0[k] * p0.x + b1[k] * p1.x + b2[k] * p2.x + b3[k] * p3.x;
+    ys[k] = b0[k] * p0.y + b1[k] * p1.y + b2[k] * p2.y + b3[k] * p3.y;
+  }
+}
+
+} // namespace warp
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <glm/vec2.hpp>
+#include <vector>
+
+namespace warp {
+
+/// Cubic Bernstein polynomials sampled at count evenly spaced t in [0, 1],
+/// so evaluating a Bezier segment is four multiply-adds per sample.
+class CBezierBasis
+{
+public:
+  explicit CBezierBasis(std::size_t count = 0);
+
+  std::size_t count() const { return m_count; }
+  float t(std::size_t k) const { return m_t[k]; }
+
+  /// Writes count() points of segment p0..p3 as separate x and y arrays.
+  void evaluate(
+      const glm::vec2& p0,
+      const glm::vec2& p1,
+      const glm::vec2& p2,
+      const glm::vec2& p3,
+      float* xs,
+      float* ys) const;
+
+private:
+  std::size_t m_count;
+  std::vector<float> m_t;
+  std::array<std::vector<float>, 4> m_basis;
+};
+
+} // namespace warp
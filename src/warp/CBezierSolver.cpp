@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CBezierSolver.hpp"
+
+#include <stdexcept>
+
+namespace warp {
+
+CBezierSolver::CBezierSolver(std::size_t count)
+  : m_count(count)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  if (count < 2)
+  {
+    throw std::invalid_argument("spline needs at least two knots");
+  }
+
+  const std::size_t num = count - 1;
+  m_m.resize(num);
+  m_b.resize(num);
+
+  /*diagonal, the right segment replaces the left most one if alone*/
+  m_b[0] = (num > 1) ? 2.f : 7.f;
+  for (std::size_t i = 1; i < num; ++i)
+  {
+    const float a = (i + 1 < num) ? 1.f : 2.f;
+    const float b = (i + 1 < num) ? 4.f : 7.f;
+    m_m[i] = a / m_b[i - 1];
+    m_b[i] = b - m_m[i];
+  }
+}
+
+void CBezierSolver::solve(
+    const glm::vec2* knots,
+    glm::vec2* p1,
+    glm::vec2* p2) const
+{
+  const std::size_t num = m_count - 1;
+  if (num == 1)
+  {
+    /*a single segment is a straight line*/
+    p1[0] = (knots[0] * 2.f + knots[1]) / 3.f;
+    p2[0] = (knots[0] + knots[1] * 2.f) / 3.f;
+    return;
+  }
+
+  /*rhs vector, eliminated in place in p1*/
+  p1[0] = knots[0] + knots[1] * 2.f;
+  for (std::size_t i = 1; i + 1 < num; ++i)
+  {
+    p1[i] = knots[i] * 4.f + knots[i + 1] * 2.f;
+  }
+  p1[num - 1] = knots[num - 1] * 8.f + knots[num];
+
+  for (std::size_t i = 1; i < num; ++i)
+  {
+    p1[i] = p1[i] - p1[i - 1] * m_m[i];
+  }
+
+  p1[num - 1] = p1[num - 1] / m_b[num - 1];
+  for (std::size_t i = num - 1; i-- > 0;)
+  {
+    p1[i] = (p1[i] - p1[i + 1]) / m_b[i];
+  }
+
+  /*we have p1, now compute p2*/
+  for (std::size_t i = 0; i + 1 < num; ++i)
+  {
+    p2[i] = knots[i + 1] * 2.f - p1[i + 1];
+  }
+  p2[num - 1] = (knots[num] + p1[num - 1]) * 0.5f;
+}
+
+} // namespace warp
@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+#include <vector>
+
+namespace warp {
+
+/// Runtime sized bezierControlPoints() for both coordinates at once. The
+/// Thomas algorithm elimination only depends on the knot count, so it is
+/// factored once and solving a spline is a forward and a back substitution.
+class CBezierSolver
+{
+public:
+  explicit CBezierSolver(std::size_t count = 0);
+
+  std::size_t count() const { return m_count; }
+
+  /// Writes the count() - 1 inner control points pairs of the spline going
+  /// through count() @p knots.
+  void solve(const glm::vec2* knots, glm::vec2* p1, glm::vec2* p2) const;
+
+private:
+  std::size_t m_count;
+  std::vector<float> m_m;
+  std::vector<float> m_b;
+};
+
+} // namespace warp
@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CCpuWarp.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace warp {
+
+CCpuWarp::CCpuWarp(CUvMap uv_map, std::size_t num_threads)
+  : m_uv_map(std::move(uv_map))
+  , m_num_threads(num_threads)
+  , m_remap_row(selectRemapRow())
+{
+  if (0 == m_num_threads)
+  {
+    m_num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  m_num_threads =
+      std::min<std::size_t>(m_num_threads, std::max(1u, size().y));
+}
+
+void CCpuWarp::apply(const Image& src, Image& dst) const
+{
+  if (src.channels != 4 || src.size.x == 0 || src.size.y == 0)
+  {
+    throw std::invalid_argument("CPU warp needs a non-empty RGBA source");
+  }
+
+  dst.size = size();
+  dst.channels = 4;
+  dst.pixels.resize(static_cast<std::size_t>(size().x) * size().y * 4);
+
+  auto remapBand = [&](std::size_t y_begin, std::size_t y_end) {
+    for (std::size_t y = y_begin; y < y_end; ++y)
+    {
+      const std::size_t offset = y * size().x;
+      m_remap_row(
+          m_uv_map.us() + offset,
+          m_uv_map.vs() + offset,
+          size().x,
+          src.pixels.data(),
+          static_cast<int>(src.size.x),
+          static_cast<int>(src.size.y),
+          dst.pixels.data() + 4 * offset);
+    }
+  };
+
+  const std::size_t band = (size().y + m_num_threads - 1) / m_num_threads;
+  std::vector<std::thread> workers;
+  workers.reserve(m_num_threads - 1);
+  for (std::size_t y = band; y < size().y; y += band)
+  {
+    workers.emplace_back(
+        remapBand, y, std::min<std::size_t>(y + band, size().y));
+  }
+  remapBand(0, std::min<std::size_t>(band, size().y));
+
+  for (auto&& worker : workers)
+  {
+    worker.join();
+  }
+}
+
+} // namespace warp
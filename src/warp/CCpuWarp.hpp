@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+
+#include "CUvMap.hpp"
+#include "Image.hpp"
+#include "Remap.hpp"
+
+namespace warp {
+
+/// Pure CPU counterpart of drawing the distortion mesh with the image
+/// program, for machines without any GL driver.
+///
+/// The mesh is rasterized once into a CUvMap, every apply() then only
+/// resamples the source image.
+class CCpuWarp
+{
+public:
+  explicit CCpuWarp(CUvMap uv_map, std::size_t num_threads = 0);
+
+  const glm::uvec2& size() const { return m_uv_map.size(); }
+  std::size_t numThreads() const { return m_num_threads; }
+  RemapRowFn remapRow() const { return m_remap_row; }
+
+  /// @p src must be RGBA, @p dst is resized to size() RGBA.
+  void apply(const Image& src, Image& dst) const;
+
+private:
+  CUvMap m_uv_map;
+  std::size_t m_num_threads;
+  RemapRowFn m_remap_row;
+};
+
+} // namespace warp
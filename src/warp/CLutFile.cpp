@@ -0,0 +1,216 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CLutFile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace warp {
+
+namespace {
+
+uint16_t quantize(float value)
+{
+  return static_cast<uint16_t>(
+      std::lround(std::clamp(value, 0.f, 1.f) * c_lut_uv_scale));
+}
+
+} // namespace
+
+void exportLut(const CUvMap& uv_map, const std::string_view& path)
+{
+  const glm::uvec2& size = uv_map.size();
+
+  LutHeader header{};
+  std::memcpy(header.magic, c_lut_magic, sizeof(header.magic));
+  header.version = c_lut_version;
+  header.format = c_lut_format_uv16;
+  header.width = size.x;
+  header.height = size.y;
+  header.row_stride = size.x * 2 * sizeof(uint16_t);
+  header.data_offset = sizeof(LutHeader);
+  header.uv_scale = c_lut_uv_scale;
+
+  std::ofstream file(path.data(), std::ios::binary);
+  if (!file)
+  {
+    std::cerr << "Couldn't create LUT " << path << std::endl;
+    throw LutError("create error");
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  std::vector<uint16_t> row(2 * size.x);
+  for (std::size_t y = 0; y < size.y; ++y)
+  {
+    const float* us = uv_map.us() + y * size.x;
+    const float* vs = uv_map.vs() + y * size.x;
+    for (std::size_t x = 0; x < size.x; ++x)
+    {
+      const bool covered = us[x] >= 0.f;
+      row[2 * x] = covered ? quantize(us[x]) : c_lut_invalid;
+      row[2 * x + 1] = covered ? quantize(vs[x]) : c_lut_invalid;
+    }
+    file.write(reinterpret_cast<const char*>(row.data()), header.row_stride);
+  }
+
+  if (!file)
+  {
+    std::cerr << "Couldn't write LUT " << path << std::endl;
+    throw LutError("write error");
+  }
+}
+
+CLutFile::CLutFile(const std::string_view& path)
+  : m_data(nullptr)
+  , m_length(0)
+{
+  int fd = ::open(path.data(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cerr << "Couldn't open LUT " << path << std::endl;
+    throw LutError("open error");
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) == 0 &&
+      st.st_size >= static_cast<off_t>(sizeof(LutHeader)))
+  {
+    m_length = static_cast<std::size_t>(st.st_size);
+    void* map = ::mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+    m_data = (map != MAP_FAILED) ? static_cast<const uint8_t*>(map) : nullptr;
+  }
+  ::close(fd);
+
+  if (nullptr == m_data)
+  {
+    std::cerr << "Couldn't map LUT " << path << std::endl;
+    throw LutError("map error");
+  }
+
+  const LutHeader& hdr = header();
+  const bool valid =
+      std::memcmp(hdr.magic, c_lut_magic, sizeof(hdr.magic)) == 0 &&
+      hdr.version == c_lut_version && hdr.format == c_lut_format_uv16 &&
+      hdr.uv_scale == c_lut_uv_scale &&
+      hdr.row_stride >= hdr.width * 2 * sizeof(uint16_t) &&
+      hdr.data_offset % alignof(uint16_t) == 0 &&
+      hdr.data_offset + std::size_t(hdr.row_stride) * hdr.height <= m_length;
+  if (!valid)
+  {
+    std::cerr << "Unsupported or truncated LUT " << path << std::endl;
+    ::munmap(const_cast<uint8_t*>(m_data), m_length);
+    m_data = nullptr;
+    throw LutError("invalid LUT");
+  }
+}
+
+CLutFile::CLutFile(CLutFile&& rhs) noexcept
+  : m_data(std::move(rhs.m_data))
+  , m_length(std::move(rhs.m_length))
+{
+  rhs.m_data = nullptr;
+}
+
+CLutFile& CLutFile::operator=(CLutFile&& rhs) noexcept
+{
+  std::swap(m_data, rhs.m_data);
+  std::swap(m_length, rhs.m_length);
+  return *this;
+}
+
+CLutFile::~CLutFile()
+{
+  if (nullptr != m_data)
+  {
+    ::munmap(const_cast<uint8_t*>(m_data), m_length);
+  }
+}
+
+const LutHeader& CLutFile::header() const
+{
+  return *reinterpret_cast<const LutHeader*>(m_data);
+}
+
+const uint16_t* CLutFile::row(std::size_t y) const
+{
+  return reinterpret_cast<const uint16_t*>(
+      m_data + header().data_offset + y * header().row_stride);
+}
+
+CUvMap CLutFile::toUvMap() const
+{
+  const glm::uvec2 lut_size = size();
+  const float scale = 1.f / header().uv_scale;
+
+  CUvMap uv_map(lut_size);
+  for (std::size_t y = 0; y < lut_size.y; ++y)
+  {
+    const uint16_t* src = row(y);
+    float* us = uv_map.us() + y * lut_size.x;
+    float* vs = uv_map.vs() + y * lut_size.x;
+    for (std::size_t x = 0; x < lut_size.x; ++x)
+    {
+      if (src[2 * x] != c_lut_invalid)
+      {
+        us[x] = src[2 * x] * scale;
+        vs[x] = src[2 * x + 1] * scale;
+      }
+    }
+  }
+  return uv_map;
+}
+
+gles2::CTexture2D CLutFile::upload() const
+{
+  const glm::uvec2 lut_size = size();
+  const std::size_t packed_stride = lut_size.x * 2 * sizeof(uint16_t);
+
+  if (header().row_stride == packed_stride)
+  {
+    return gles2::CTexture2D(
+        lut_size,
+        GL_RGBA,
+        reinterpret_cast<const uint8_t*>(row(0)),
+        GL_NEAREST);
+  }
+
+  std::vector<uint8_t> packed(packed_stride * lut_size.y);
+  for (std::size_t y = 0; y < lut_size.y; ++y)
+  {
+    std::memcpy(packed.data() + y * packed_stride, row(y), packed_stride);
+  }
+  return gles2::CTexture2D(lut_size, GL_RGBA, packed.data(), GL_NEAREST);
+}
+
+} // namespace warp
@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <stdexcept>
+#include <string_view>
+
+#include "CUvMap.hpp"
+#include "gles2/CTexture2D.hpp"
+
+namespace warp {
+
+struct LutError : std::runtime_error
+{
+  using std::runtime_error::runtime_error;
+};
+
+inline constexpr char c_lut_magic[4] = {'D', 'O', 'L', 'T'};
+inline constexpr uint32_t c_lut_version = 1;
+inline constexpr uint32_t c_lut_format_uv16 = 1;
+inline constexpr uint16_t c_lut_uv_scale = 65534;
+inline constexpr uint16_t c_lut_invalid = 0xffff;
+
+/// Baked warp LUT file layout, every field is little endian:
+///
+/// [0, 64)            LutHeader
+/// [data_offset, ...) height rows of row_stride bytes, row 0 is the bottom
+///                    one. A pixel is a pair of uint16 (u, v), the source
+///                    coordinate is value / uv_scale and c_lut_invalid in u
+///                    marks pixels with nothing to sample. uv_scale is
+///                    c_lut_uv_scale, so coordinates stay within [0, 1].
+struct LutHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint32_t format;
+  uint32_t width;
+  uint32_t height;
+  uint32_t row_stride;
+  uint32_t data_offset;
+  uint32_t uv_scale;
+  uint8_t reserved[32];
+};
+static_assert(sizeof(LutHeader) == 64, "LUT header must stay 64 bytes");
+
+void exportLut(const CUvMap& uv_map, const std::string_view& path);
+
+/// Read-only memory mapping of a LUT file written by exportLut().
+class CLutFile
+{
+public:
+  explicit CLutFile(const std::string_view& path);
+  CLutFile(CLutFile&& rhs) noexcept;
+  CLutFile& operator=(CLutFile&& rhs) noexcept;
+  CLutFile(const CLutFile&) = delete;
+  CLutFile& operator=(CLutFile&) = delete;
+  ~CLutFile();
+
+  const LutHeader& header() const;
+  glm::uvec2 size() const { return {header().width, header().height}; }
+  const uint16_t* row(std::size_t y) const;
+
+  CUvMap toUvMap() const;
+
+  /// Uploads the LUT as a GL_NEAREST RGBA texture, each texel keeps the
+  /// little endian bytes of one (u, v) pair for c_lut_fshader_src.
+  gles2::CTexture2D upload() const;
+
+private:
+  const uint8_t* m_data;
+  std::size_t m_length;
+};
+
+} // namespace warp
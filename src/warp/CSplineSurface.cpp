@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CSplineSurface.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "CBezierSolver.hpp"
+
+namespace warp {
+
+CSplineSurface::CSplineSurface(const KeyPoints& kps)
+  : m_patches(kps.size - 1u)
+{
+  if (kps.size.x < 2 || kps.size.y < 2)
+  {
+    throw std::invalid_argument("key points grid needs 2+ points per side");
+  }
+
+  const glm::uvec2 size = netSize();
+  m_net.resize(std::size_t{size.x} * size.y);
+  std::vector<glm::vec2> knots(std::max(kps.size.x, kps.size.y));
+  std::vector<glm::vec2> p1(knots.size());
+  std::vector<glm::vec2> p2(knots.size());
+
+  /*splines along the key point rows fill every third net row*/
+  const CBezierSolver row_solver(kps.size.x);
+  for (std::size_t j = 0; j < kps.size.y; ++j)
+  {
+    for (std::size_t i = 0; i < kps.size.x; ++i)
+    {
+      knots[i] = kps.at(i, j);
+    }
+    row_solver.solve(knots.data(), p1.data(), p2.data());
+
+    glm::vec2* row = &m_net[3 * j * size.x];
+    for (std::size_t i = 0; i < m_patches.x; ++i)
+    {
+      row[3 * i] = knots[i];
+      row[3 * i + 1] = p1[i];
+      row[3 * i + 2] = p2[i];
+    }
+    row[size.x - 1] = knots[m_patches.x];
+  }
+
+  /*splines across those rows fill the rest of each net column*/
+  const CBezierSolver column_solver(kps.size.y);
+  for (std::size_t x = 0; x < size.x; ++x)
+  {
+    for (std::size_t j = 0; j < kps.size.y; ++j)
+    {
+      knots[j] = m_net[3 * j * size.x + x];
+    }
+    column_solver.solve(knots.data(), p1.data(), p2.data());
+    for (std::size_t j = 0; j < m_patches.y; ++j)
+    {
+      m_net[(3 * j + 1) * size.x + x] = p1[j];
+      m_net[(3 * j + 2) * size.x + x] = p2[j];
+    }
+  }
+}
+
+glm::vec2 CSplineSurface::evaluate(const glm::vec2& uv) const
+{
+  const glm::uvec2 size = netSize();
+  std::size_t origin[2];
+  float basis[2][4];
+  for (int axis = 0; axis < 2; ++axis)
+  {
+    const float scaled = uv[axis] * m_patches[axis];
+    const float patch = std::clamp(
+        std::floor(scaled), 0.f, static_cast<float>(m_patches[axis] - 1));
+    const float t = scaled - patch;
+    const float s = 1.f - t;
+    origin[axis] = 3 * static_cast<std::size_t>(patch);
+    basis[axis][0] = s * s * s;
+    basis[axis][1] = 3.f * t * s * s;
+    basis[axis][2] = 3.f * t * t * s;
+    basis[axis][3] = t * t * t;
+  }
+
+  glm::vec2 point(0.f);
+  for (std::size_t b = 0; b < 4; ++b)
+  {
+    const glm::vec2* row = &m_net[(origin[1] + b) * size.x + origin[0]];
+    const glm::vec2 along = row[0] * basis[0][0] + row[1] * basis[0][1] +
+                            row[2] * basis[0][2] + row[3] * basis[0][3];
+    point += along * basis[1][b];
+  }
+  return point;
+}
+
+} // namespace warp
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+#include <vector>
+
+#include "KeyPoints.hpp"
+
+namespace warp {
+
+/// The surface generateDistortionVertices() samples, as one bicubic Bezier
+/// patch per key points cell. Splines are linear in their knots, so the
+/// splines across the rows of the row spline control points give the
+/// control net, which evaluates the surface at any (u, v) in [0, 1]^2.
+class CSplineSurface
+{
+public:
+  explicit CSplineSurface(const KeyPoints& kps);
+
+  /// Patches per side, one less than the key points.
+  const glm::uvec2& patches() const { return m_patches; }
+
+  /// 3 * patches() + 1 control points per side, stored row by row, patch
+  /// (i, j) uses columns 3i..3i+3 of rows 3j..3j+3.
+  glm::uvec2 netSize() const { return m_patches * 3u + 1u; }
+  const std::vector<glm::vec2>& net() const { return m_net; }
+
+  glm::vec2 evaluate(const glm::vec2& uv) const;
+
+private:
+  glm::uvec2 m_patches;
+  std::vector<glm::vec2> m_net;
+};
+
+} // namespace warp
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CUvMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace warp {
+
+CUvMap::CUvMap(const glm::uvec2& size)
+  : m_size(size)
+  , m_us(static_cast<std::size_t>(size.x) * size.y, -1.f)
+  , m_vs(static_cast<std::size_t>(size.x) * size.y, -1.f)
+{
+}
+
+CUvMap::CUvMap(
+    const gles2::CMesh::Vertices& vertices,
+    const gles2::CMesh::Indices& indices,
+    const glm::uvec2& size)
+  : CUvMap(size)
+{
+  // Same topology glDrawElements(GL_TRIANGLE_STRIP) produces, degenerate
+  // triangles gluing the strip rows together are skipped
+  for (std::size_t i = 2; i < indices.size(); ++i)
+  {
+    const auto i0 = indices[i - 2];
+    const auto i1 = indices[i - 1];
+    const auto i2 = indices[i];
+    if (i0 != i1 && i1 != i2 && i0 != i2)
+    {
+      rasterize(vertices.at(i0), vertices.at(i1), vertices.at(i2));
+    }
+  }
+}
+
+void CUvMap::rasterize(
+    const gles2::CMesh::Vertex& a,
+    const gles2::CMesh::Vertex& b,
+    const gles2::CMesh::Vertex& c)
+{
+  // NDC to window coordinates, row 0 is the bottom one as in glReadPixels
+  auto toWindow = [this](const glm::vec3& p) {
+    return glm::vec2(
+        (p.x + 1.f) * 0.5f * m_size.x, (p.y + 1.f) * 0.5f * m_size.y);
+  };
+  const glm::vec2 pa = toWindow(a.position);
+  const glm::vec2 pb = toWindow(b.position);
+  const glm::vec2 pc = toWindow(c.position);
+
+  auto edge = [](const glm::vec2& p0, const glm::vec2& p1, float x, float y) {
+    return (p1.x - p0.x) * (y - p0.y) - (p1.y - p0.y) * (x - p0.x);
+  };
+  const float area = edge(pa, pb, pc.x, pc.y);
+  if (0.f == area)
+  {
+    return;
+  }
+
+  const int x_min = std::max(0, static_cast<int>(std::floor(
+                                    std::min({pa.x, pb.x, pc.x}) - 0.5f)));
+  const int y_min = std::max(0, static_cast<int>(std::floor(
+                                    std::min({pa.y, pb.y, pc.y}) - 0.5f)));
+  const int x_max = std::min(
+      static_cast<int>(m_size.x) - 1,
+      static_cast<int>(std::ceil(std::max({pa.x, pb.x, pc.x}) - 0.5f)));
+  const int y_max = std::min(
+      static_cast<int>(m_size.y) - 1,
+      static_cast<int>(std::ceil(std::max({pa.y, pb.y, pc.y}) - 0.5f)));
+
+  for (int y = y_min; y <= y_max; ++y)
+  {
+    const float py = y + 0.5f;
+    for (int x = x_min; x <= x_max; ++x)
+    {
+      const float px = x + 0.5f;
+      const float wa = edge(pb, pc, px, py) / area;
+      const float wb = edge(pc, pa, px, py) / area;
+      const float wc = 1.f - wa - wb;
+      if (wa < 0.f || wb < 0.f || wc < 0.f)
+      {
+        continue;
+      }
+
+      const glm::vec2 uv = a.text0 * wa + b.text0 * wb + c.text0 * wc;
+      const std::size_t index = static_cast<std::size_t>(y) * m_size.x + x;
+      m_us[index] = std::clamp(uv.x, 0.f, 1.f);
+      m_vs[index] = std::clamp(uv.y, 0.f, 1.f);
+    }
+  }
+}
+
+} // namespace warp
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+#include <vector>
+
+#include "gles2/CMesh.hpp"
+
+namespace warp {
+
+/// Per-pixel source texture coordinates of a warped output, row 0 is the
+/// bottom one as in GL. Pixels not covered by the mesh have negative u.
+class CUvMap
+{
+public:
+  explicit CUvMap(const glm::uvec2& size);
+  explicit CUvMap(
+      const gles2::CMesh::Vertices& vertices,
+      const gles2::CMesh::Indices& indices,
+      const glm::uvec2& size);
+
+  const glm::uvec2& size() const { return m_size; }
+
+  const float* us() const { return m_us.data(); }
+  const float* vs() const { return m_vs.data(); }
+  float* us() { return m_us.data(); }
+  float* vs() { return m_vs.data(); }
+
+private:
+  void rasterize(
+      const gles2::CMesh::Vertex& a,
+      const gles2::CMesh::Vertex& b,
+      const gles2::CMesh::Vertex& c);
+
+  glm::uvec2 m_size;
+  std::vector<float> m_us;
+  std::vector<float> m_vs;
+};
+
+} // namespace warp
@@ -0,0 +1,362 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "DistortionMesh.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "CBezierBasis.hpp"
+#include "CBezierSolver.hpp"
+#include "CSplineSurface.hpp"
+#include "Tessellation.hpp"
+
+namespace warp {
+
+namespace {
+
+struct Scratch
+{
+  CBezierBasis basis_x;
+  CBezierBasis basis_y;
+  CBezierSolver row_solver;
+  CBezierSolver column_solver;
+  std::vector<glm::vec2> row_p1;
+  std::vector<glm::vec2> row_p2;
+  std::vector<float> row_xs;
+  std::vector<float> row_ys;
+  std::vector<glm::vec2> knots;
+  std::vector<glm::vec2> p1;
+  std::vector<glm::vec2> p2;
+  std::vector<float> xs;
+  std::vector<float> ys;
+  gles2::CMesh::Vertices vertices;
+
+  void prepare(const glm::uvec2& grid_size, const glm::uvec2& seg_count)
+  {
+    if (row_solver.count() != grid_size.x)
+    {
+      row_solver = CBezierSolver(grid_size.x);
+    }
+    if (column_solver.count() != grid_size.y)
+    {
+      column_solver = CBezierSolver(grid_size.y);
+    }
+    if (basis_x.count() != seg_count.x)
+    {
+      basis_x = CBezierBasis(seg_count.x);
+    }
+    if (basis_y.count() != seg_count.y)
+    {
+      basis_y = CBezierBasis(seg_count.y);
+    }
+
+    row_p1.resize((grid_size.x - 1) * grid_size.y);
+    row_p2.resize((grid_size.x - 1) * grid_size.y);
+    row_xs.resize(seg_count.x * grid_size.y);
+    row_ys.resize(seg_count.x * grid_size.y);
+    knots.resize(std::max(grid_size.x, grid_size.y));
+    p1.resize(std::max(grid_size.x, grid_size.y));
+    p2.resize(std::max(grid_size.x, grid_size.y));
+    xs.resize(seg_count.y);
+    ys.resize(seg_count.y);
+  }
+};
+
+// Keeps basis tables and sample buffers between calls, so regenerating a
+// mesh of the same density doesn't allocate
+thread_local Scratch t_scratch;
+
+} // namespace
+
+glm::uvec2 distortionMeshSize(std::size_t count, const glm::uvec2& grid_size)
+{
+  if (grid_size.x < 2 || grid_size.y < 2)
+  {
+    throw std::invalid_argument("key points grid needs 2+ points per side");
+  }
+
+  const glm::uvec2 seg_count(
+      count / (grid_size.x - 1), count / (grid_size.y - 1));
+  if (seg_count.x < 2 || seg_count.y < 2)
+  {
+    throw std::invalid_argument("distortion mesh needs 2+ points per segment");
+  }
+  return seg_count * (grid_size - 1u);
+}
+
+void generateDistortionVertices(
+    std::size_t count,
+    const KeyPoints& kps,
+    gles2::CMesh::Vertices& vertices)
+{
+  const glm::uvec2 grid_size = kps.size;
+  const glm::uvec2 size = distortionMeshSize(count, grid_size);
+  const glm::uvec2 seg_count = size / (grid_size - 1u);
+  const std::size_t num_x = grid_size.x - 1;
+  const std::size_t num_y = grid_size.y - 1;
+
+  auto& s = t_scratch;
+  s.prepare(grid_size, seg_count);
+  vertices.resize(size.x * size.y);
+
+  /*splines along the key point rows*/
+  for (std::size_t j = 0; j < grid_size.y; ++j)
+  {
+    for (std::size_t i = 0; i < grid_size.x; ++i)
+    {
+      s.knots[i] = kps.at(i, j);
+    }
+    s.row_solver.solve(
+        s.knots.data(), &s.row_p1[j * num_x], &s.row_p2[j * num_x]);
+  }
+
+  for (std::size_t i = 0; i < num_x; ++i)
+  {
+    for (std::size_t j = 0; j < grid_size.y; ++j)
+    {
+      s.basis_x.evaluate(
+          kps.at(i, j),
+          s.row_p1[j * num_x + i],
+          s.row_p2[j * num_x + i],
+          kps.at(i + 1, j),
+          &s.row_xs[j * seg_count.x],
+          &s.row_ys[j * seg_count.x]);
+    }
+
+    for (std::size_t ii = 0; ii < seg_count.x; ++ii)
+    {
+      /*spline across the rows at this column*/
+      for (std::size_t j = 0; j < grid_size.y; ++j)
+      {
+        s.knots[j] = glm::vec2(
+            s.row_xs[j * seg_count.x + ii], s.row_ys[j * seg_count.x + ii]);
+      }
+      s.column_solver.solve(s.knots.data(), s.p1.data(), s.p2.data());
+      const float u = i / static_cast<float>(num_x) +
+                      1.f / num_x * s.basis_x.t(ii);
+
+      gles2::CMesh::Vertex* out = &vertices[(i * seg_count.x + ii) * size.y];
+      for (std::size_t j = 0; j < num_y; ++j)
+      {
+        s.basis_y.evaluate(
+            s.knots[j],
+            s.p1[j],
+            s.p2[j],
+            s.knots[j + 1],
+            s.xs.data(),
+            s.ys.data());
+        for (std::size_t jj = 0; jj < seg_count.y; ++jj)
+        {
+          *out++ = {
+              glm::vec3(s.xs[jj], s.ys[jj], 0.f),
+              glm::vec2(
+                  u,
+                  j / static_cast<float>(num_y) +
+                      1.f / num_y * s.basis_y.t(jj))};
+        }
+      }
+    }
+  }
+}
+
+gles2::CMesh::Vertices generateDistortionVertices(
+    std::size_t count,
+    const KeyPoints& kps)
+{
+  gles2::CMesh::Vertices vertices;
+  generateDistortionVertices(count, kps, vertices);
+  return vertices;
+}
+
+gles2::CMesh::Indices generateGridIndices(const glm::uvec2& size)
+{
+  gles2::CMesh::Indices indices;
+  indices.reserve((size.x - 1) * (2 * size.y + 2));
+  for (std::size_t i = 1; i < size.x; ++i)
+  {
+    for (std::size_t j = 0; j < size.y; ++j)
+    {
+      uint32_t x1 = (i - 1) * size.y + j;
+      uint32_t x2 = (i - 1) * size.y + j + size.y;
+
+      if (j == 0 && i != 1)
+      {
+        indices.push_back(x1);
+      }
+      indices.push_back(x1);
+      indices.push_back(x2);
+    }
+    indices.push_back(indices.back());
+  }
+
+  return indices;
+}
+
+gles2::CMesh::Indices generateDistortionIndices(
+    std::size_t count,
+    const glm::uvec2& grid_size)
+{
+  return generateGridIndices(distortionMeshSize(count, grid_size));
+}
+
+gles2::CMesh generateDistortionMesh(
+    std::size_t count,
+    const KeyPoints& kps,
+    GLenum vertex_usage)
+{
+  return gles2::CMesh(
+      generateDistortionVertices(count, kps),
+      generateDistortionIndices(count, kps.size),
+      vertex_usage);
+}
+
+void generateDistortionGrid(
+    const MeshDensity& density,
+    const KeyPoints& kps,
+    gles2::CMesh::Vertices& vertices,
+    gles2::CMesh::Indices& indices,
+    float* max_error)
+{
+  if (!density.adaptive())
+  {
+    generateDistortionVertices(density.count, kps, vertices);
+    indices = generateDistortionIndices(density.count, kps.size);
+    return;
+  }
+
+  const CSplineSurface surface(kps);
+  const Tessellation tessellation =
+      tessellateSurface(surface, density.viewport, density.tolerance);
+  generateTessellationVertices(surface, tessellation, vertices);
+  indices = generateGridIndices(tessellation.size());
+  if (max_error)
+  {
+    *max_error = tessellation.max_error;
+  }
+}
+
+gles2::CMesh generateDistortionMesh(
+    const MeshDensity& density,
+    const KeyPoints& kps,
+    GLenum vertex_usage,
+    float* max_error)
+{
+  gles2::CMesh::Vertices vertices;
+  gles2::CMesh::Indices indices;
+  generateDistortionGrid(density, kps, vertices, indices, max_error);
+  return gles2::CMesh(std::move(vertices), std::move(indices), vertex_usage);
+}
+
+gles2::CMesh generateParameterMesh(
+    std::size_t count,
+    const glm::uvec2& grid_size)
+{
+  // Default key points sample to the identity, so the vertices carry the
+  // same parameters as any other key points of the grid size
+  return generateDistortionMesh(count, makeDefaultKeyPoints(grid_size));
+}
+
+namespace {
+
+gles2::CMesh::Vertices generateKeyPointsVertices(const KeyPoints& kps)
+{
+  gles2::CMesh::Vertices dist_vertices;
+  dist_vertices.reserve(kps.count());
+  for (auto&& p : kps.points)
+  {
+    dist_vertices.push_back({glm::vec3(p, 0.f), glm::vec2(0.f)});
+  }
+  return dist_vertices;
+}
+
+} // namespace
+
+gles2::CMesh generateKeyPointsMesh(const KeyPoints& kps, GLenum vertex_usage)
+{
+  return gles2::CMesh(
+      generateKeyPointsVertices(kps),
+      generateGridIndices(kps.size),
+      vertex_usage);
+}
+
+void updateDistortionMesh(
+    gles2::CMesh& mesh,
+    std::size_t count,
+    const KeyPoints& kps)
+{
+  // The whole surface is evaluated again: the splines interpolate their
+  // knots, so solving for the control points couples every knot of a row
+  // or column with all the others. A moved knot shifts every patch of the
+  // grid, by an amount which shrinks about four times per knot away. Only
+  // where that falls below float precision do vertices stay bit equal and
+  // updateVertices() skips them.
+  generateDistortionVertices(count, kps, t_scratch.vertices);
+  mesh.updateVertices(t_scratch.vertices);
+}
+
+void updateDistortionMesh(
+    gles2::CMesh& mesh,
+    const MeshDensity& density,
+    const KeyPoints& kps,
+    float* max_error)
+{
+  if (!density.adaptive())
+  {
+    updateDistortionMesh(mesh, density.count, kps);
+    return;
+  }
+
+  gles2::CMesh::Indices indices;
+  generateDistortionGrid(density, kps, t_scratch.vertices, indices, max_error);
+  if (indices == mesh.getIndices())
+  {
+    mesh.updateVertices(t_scratch.vertices);
+  }
+  else
+  {
+    mesh = gles2::CMesh(
+        t_scratch.vertices, std::move(indices), GL_DYNAMIC_DRAW);
+  }
+}
+
+void updateKeyPointsMesh(gles2::CMesh& mesh, const KeyPoints& kps)
+{
+  mesh.updateVertices(generateKeyPointsVertices(kps));
+}
+
+gles2::CMesh generateQuadMesh()
+{
+  gles2::CMesh::Vertices vertices = {
+      {glm::vec3(-1.f, -1.f, 0.f), glm::vec2(0.f, 0.f)},
+      {glm::vec3(1.f, -1.f, 0.f), glm::vec2(1.f, 0.f)},
+      {glm::vec3(-1.f, 1.f, 0.f), glm::vec2(0.f, 1.f)},
+      {glm::vec3(1.f, 1.f, 0.f), glm::vec2(1.f, 1.f)},
+  };
+  return gles2::CMesh(std::move(vertices), {0, 1, 2, 3});
+}
+
+} // namespace warp
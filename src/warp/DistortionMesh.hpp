@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+
+#include "KeyPoints.hpp"
+#include "gles2/CMesh.hpp"
+
+namespace warp {
+
+/// How the spline surface is sampled: count points per side, or with a
+/// tolerance above zero the tessellateSurface() grid within that many
+/// pixels at the viewport size.
+struct MeshDensity
+{
+  std::size_t count;
+  float tolerance;
+  glm::uvec2 viewport;
+
+  bool adaptive() const { return tolerance > 0.f; }
+};
+
+/// Size of the vertex grid sampled from a key points grid of @p grid_size,
+/// each segment between key points gets count / (grid_size - 1) samples.
+glm::uvec2 distortionMeshSize(std::size_t count, const glm::uvec2& grid_size);
+
+/// Fills @p vertices with the distortionMeshSize() grid sampled from the
+/// spline surface through the key points, reusing its storage.
+void generateDistortionVertices(
+    std::size_t count,
+    const KeyPoints& kps,
+    gles2::CMesh::Vertices& vertices);
+gles2::CMesh::Vertices generateDistortionVertices(
+    std::size_t count,
+    const KeyPoints& kps);
+/// Triangle strip over a column by column stored grid of @p size vertices.
+gles2::CMesh::Indices generateGridIndices(const glm::uvec2& size);
+gles2::CMesh::Indices generateDistortionIndices(
+    std::size_t count,
+    const glm::uvec2& grid_size);
+
+gles2::CMesh generateDistortionMesh(
+    std::size_t count,
+    const KeyPoints& kps,
+    GLenum vertex_usage = GL_STATIC_DRAW);
+
+/// Vertices and indices of @p density, the max error of an adaptive grid
+/// goes to @p max_error when given.
+void generateDistortionGrid(
+    const MeshDensity& density,
+    const KeyPoints& kps,
+    gles2::CMesh::Vertices& vertices,
+    gles2::CMesh::Indices& indices,
+    float* max_error = nullptr);
+gles2::CMesh generateDistortionMesh(
+    const MeshDensity& density,
+    const KeyPoints& kps,
+    GLenum vertex_usage = GL_STATIC_DRAW,
+    float* max_error = nullptr);
+/// The (u, v) grid of generateDistortionMesh() for any key points of
+/// @p grid_size, positioned as if undistorted. Drawn with the surface
+/// shaders it never changes, see warp::surfaceVertexShader().
+gles2::CMesh generateParameterMesh(
+    std::size_t count,
+    const glm::uvec2& grid_size);
+gles2::CMesh generateKeyPointsMesh(
+    const KeyPoints& kps,
+    GLenum vertex_usage = GL_STATIC_DRAW);
+
+/// Refresh meshes made by the generators above with new key points,
+/// indices and GL buffers are kept and only changed vertices are uploaded.
+void updateDistortionMesh(
+    gles2::CMesh& mesh,
+    std::size_t count,
+    const KeyPoints& kps);
+/// Adaptive grids rebuild @p mesh whenever the new key points need a grid
+/// of another size.
+void updateDistortionMesh(
+    gles2::CMesh& mesh,
+    const MeshDensity& density,
+    const KeyPoints& kps,
+    float* max_error = nullptr);
+void updateKeyPointsMesh(gles2::CMesh& mesh, const KeyPoints& kps);
+gles2::CMesh generateQuadMesh();
+
+} // namespace warp
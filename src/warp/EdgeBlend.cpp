@@ -0,0 +1,54 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "EdgeBlend.hpp"
+
+namespace warp {
+
+bool EdgeBlend::active() const
+{
+  return widths != glm::vec4(0.f) || brightness != 1.f || !mask_path.empty();
+}
+
+bool operator==(const EdgeBlend& lhs, const EdgeBlend& rhs)
+{
+  return lhs.widths == rhs.widths && lhs.curve == rhs.curve &&
+         lhs.gamma == rhs.gamma && lhs.brightness == rhs.brightness &&
+         lhs.mask_path == rhs.mask_path;
+}
+
+void setEdgeBlendUniforms(
+    gles2::CShaderProgram& program,
+    const EdgeBlend& blend,
+    bool has_mask)
+{
+  program.setUniform("u_blend_widths", blend.widths);
+  program.setUniform("u_blend_curve", blend.curve);
+  program.setUniform("u_blend_gamma", blend.gamma);
+  program.setUniform("u_brightness", blend.brightness);
+  program.setUniform("u_mask", static_cast<GLint>(c_blend_mask_unit));
+  program.setUniform("u_mask_weight", has_mask ? 1.f : 0.f);
+}
+
+} // namespace warp
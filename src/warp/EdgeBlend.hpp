@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec4.hpp>
+#include <string>
+
+#include "gles2/CShaderProgram.hpp"
+
+namespace warp {
+
+/// Soft edges of a projector overlapping its neighbours, applied by the
+/// warp fragment shader in the same pass that samples the image.
+///
+/// Each edge fades over its width, a fraction of the output, along an S
+/// curve whose steepness is @p curve. The product of the edge ramps is
+/// raised to 1 / gamma to compensate the projector response, then scaled
+/// by @p brightness and by the red channel of the optional mask image,
+/// which spans the whole output.
+struct EdgeBlend
+{
+  glm::vec4 widths{0.f}; ///< left, right, bottom, top
+  float curve = 2.f;
+  float gamma = 2.2f;
+  float brightness = 1.f;
+  std::string mask_path;
+
+  bool active() const;
+};
+
+bool operator==(const EdgeBlend& lhs, const EdgeBlend& rhs);
+inline bool operator!=(const EdgeBlend& lhs, const EdgeBlend& rhs)
+{
+  return !(lhs == rhs);
+}
+
+/// Texture unit of the mask image, after the sources and the LUT.
+inline constexpr std::size_t c_blend_mask_unit = 4;
+
+/// The program has to be in use and built from warp::c_blend_src.
+void setEdgeBlendUniforms(
+    gles2::CShaderProgram& program,
+    const EdgeBlend& blend,
+    bool has_mask);
+
+} // namespace warp
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "Image.hpp"
+
+#include <FreeImage.h>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include "gles2/Swizzle.hpp"
+
+namespace warp {
+
+Image loadImage(const std::string_view& path)
+{
+  FIBITMAP* bitmap =
+      FreeImage_Load(FreeImage_GetFileType(path.data(), 0), path.data());
+  if (nullptr == bitmap)
+  {
+    std::cerr << "Couldn't load image " << path << std::endl;
+    throw ImageLoadError("load error");
+  }
+
+  FIBITMAP* rgba = FreeImage_ConvertTo32Bits(bitmap);
+  FreeImage_Unload(bitmap);
+  if (nullptr == rgba)
+  {
+    throw ImageLoadError("couldn't convert image to 32 bpp");
+  }
+
+  Image image{
+      {FreeImage_GetWidth(rgba), FreeImage_GetHeight(rgba)}, 4, {}};
+  const std::size_t row_size = image.size.x * image.channels;
+  image.pixels.resize(row_size * image.size.y);
+  static const gles2::SwapRedBlueFn swap_red_blue = gles2::selectSwapRedBlue();
+  for (unsigned y = 0; y < image.size.y; ++y)
+  {
+    uint8_t* row = image.pixels.data() + y * row_size;
+    std::memcpy(row, FreeImage_GetScanLine(rgba, y), row_size);
+    swap_red_blue(row, image.size.x, image.channels);
+  }
+
+  FreeImage_Unload(rgba);
+  return image;
+}
+
+void saveImage(const Image& image, const std::string_view& path)
+{
+  const unsigned bpp = static_cast<unsigned>(image.channels * 8);
+  const int pitch = static_cast<int>(image.size.x * image.channels);
+
+  // FreeImage keeps pixels as BGR(A) on little endian machines
+  std::vector<uint8_t> bits(image.pixels);
+  for (std::size_t i = 0; i + 2 < bits.size(); i += image.channels)
+  {
+    std::swap(bits[i], bits[i + 2]);
+  }
+
+  FIBITMAP* bitmap = FreeImage_ConvertFromRawBits(
+      bits.data(),
+      image.size.x,
+      image.size.y,
+      pitch,
+      bpp,
+      FI_RGBA_RED_MASK,
+      FI_RGBA_GREEN_MASK,
+      FI_RGBA_BLUE_MASK);
+  if (nullptr == bitmap)
+  {
+    throw ImageSaveError("couldn't convert image");
+  }
+
+  FREE_IMAGE_FORMAT format = FreeImage_GetFIFFromFilename(path.data());
+  if (FIF_UNKNOWN == format)
+  {
+    format = FIF_PNG;
+  }
+
+  const bool saved = FreeImage_Save(format, bitmap, path.data());
+  FreeImage_Unload(bitmap);
+  if (!saved)
+  {
+    std::cerr << "Couldn't save image " << path << std::endl;
+    throw ImageSaveError("save error");
+  }
+}
+
+} // namespace warp
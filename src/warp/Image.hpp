@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace warp {
+
+struct ImageLoadError : std::runtime_error
+{
+  using std::runtime_error::runtime_error;
+};
+
+struct ImageSaveError : std::runtime_error
+{
+  using std::runtime_error::runtime_error;
+};
+
+/// Tightly packed 8-bit RGB(A) pixels, rows go bottom-up as in GL.
+struct Image
+{
+  glm::uvec2 size;
+  std::size_t channels;
+  std::vector<uint8_t> pixels;
+};
+
+/// Decodes any image FreeImage understands into 4-channel RGBA.
+Image loadImage(const std::string_view& path);
+void saveImage(const Image& image, const std::string_view& path);
+
+} // namespace warp
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "KeyPoints.hpp"
+
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace warp {
+
+KeyPoints makeDefaultKeyPoints(const glm::uvec2& grid_size)
+{
+  if (grid_size.x < 2 || grid_size.y < 2)
+  {
+    throw std::invalid_argument("key points grid needs 2+ points per side");
+  }
+
+  KeyPoints kps{
+      grid_size, std::vector<glm::vec2>(grid_size.x * grid_size.y), {}};
+  for (std::size_t i = 0; i < grid_size.x; ++i)
+  {
+    for (std::size_t j = 0; j < grid_size.y; ++j)
+    {
+      kps.at(i, j) = glm::vec2(
+          -1.f + 2.f * i / (grid_size.x - 1),
+          -1.f + 2.f * j / (grid_size.y - 1));
+    }
+  }
+  return kps;
+}
+
+void storeKeyPoints(const KeyPoints& kps, const std::string_view& filename)
+{
+  if (std::ofstream file(filename.data()); file)
+  {
+    file << "grid " << kps.size.x << " " << kps.size.y << "\n";
+    for (auto&& p : kps.points)
+    {
+      file << p.x << " " << p.y << "\n";
+    }
+    if (const EdgeBlend& blend = kps.blend; blend.active())
+    {
+      file << "blend " << blend.widths.x << " " << blend.widths.y << " "
+           << blend.widths.z << " " << blend.widths.w << "\n"
+           << "blend_curve " << blend.curve << "\n"
+           << "gamma " << blend.gamma << "\n"
+           << "brightness " << blend.brightness << "\n";
+      if (!blend.mask_path.empty())
+      {
+        file << "mask " << std::quoted(blend.mask_path) << "\n";
+      }
+    }
+    std::cout << "Saved to " << std::quoted(filename.data()) << std::endl;
+  }
+}
+
+KeyPoints loadKeyPoints(const std::string_view& filename)
+{
+  std::ifstream file(filename.data());
+  if (!file)
+  {
+    std::cerr << "Couldn't open key points " << filename << std::endl;
+    throw KeyPointsLoadError("open error");
+  }
+
+  KeyPoints kps{c_default_grid_size, {}, {}};
+  if (std::isalpha((file >> std::ws).peek()))
+  {
+    std::string keyword;
+    file >> keyword >> kps.size.x >> kps.size.y;
+    if (!file || keyword != "grid" || kps.size.x < 2 || kps.size.y < 2)
+    {
+      std::cerr << "Bad key points header in " << filename << std::endl;
+      throw KeyPointsLoadError("header error");
+    }
+  }
+
+  kps.points.resize(kps.size.x * kps.size.y);
+  for (auto& p : kps.points)
+  {
+    file >> p.x >> p.y;
+  }
+  if (!file)
+  {
+    std::cerr << "Couldn't parse key points " << filename << std::endl;
+    throw KeyPointsLoadError("parse error");
+  }
+
+  EdgeBlend& blend = kps.blend;
+  for (std::string keyword; file >> keyword;)
+  {
+    if (keyword == "blend")
+    {
+      file >> blend.widths.x >> blend.widths.y >> blend.widths.z >>
+          blend.widths.w;
+    }
+    else if (keyword == "blend_curve")
+    {
+      file >> blend.curve;
+    }
+    else if (keyword == "gamma")
+    {
+      file >> blend.gamma;
+    }
+    else if (keyword == "brightness")
+    {
+      file >> blend.brightness;
+    }
+    else if (keyword == "mask")
+    {
+      file >> std::quoted(blend.mask_path);
+      const std::filesystem::path mask(blend.mask_path);
+      if (mask.is_relative())
+      {
+        blend.mask_path =
+            (std::filesystem::path(filename).parent_path() / mask).string();
+      }
+    }
+    else
+    {
+      file.setstate(std::ios::failbit);
+    }
+
+    if (!file)
+    {
+      std::cerr << "Bad calibration entry " << keyword << " in " << filename
+                << std::endl;
+      throw KeyPointsLoadError("parse error");
+    }
+  }
+  return kps;
+}
+
+} // namespace warp
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "EdgeBlend.hpp"
+
+namespace warp {
+
+struct KeyPointsLoadError : std::runtime_error
+{
+  using std::runtime_error::runtime_error;
+};
+
+/// Grid of size.x columns by size.y rows key points, stored column by
+/// column, e.g. for the 4x4 grid:
+///
+/// P03 -- P13 -- P23 -- P33
+///  |      |      |      |
+/// P02 -- P12 -- P22 -- P32
+///  |      |      |      |
+/// P01 -- P11 -- P21 -- P31
+///  |      |      |      |
+/// P00 -- P10 -- P20 -- P30
+///
+/// Pij is points[i * size.y + j].
+///
+/// The edge blending of the output is part of the same calibration.
+struct KeyPoints
+{
+  glm::uvec2 size{0u, 0u};
+  std::vector<glm::vec2> points;
+  EdgeBlend blend;
+
+  std::size_t count() const { return points.size(); }
+
+  glm::vec2& operator[](std::size_t index) { return points[index]; }
+  const glm::vec2& operator[](std::size_t index) const
+  {
+    return points[index];
+  }
+
+  glm::vec2& at(std::size_t i, std::size_t j)
+  {
+    return points[i * size.y + j];
+  }
+  const glm::vec2& at(std::size_t i, std::size_t j) const
+  {
+    return points[i * size.y + j];
+  }
+};
+
+inline bool operator==(const KeyPoints& lhs, const KeyPoints& rhs)
+{
+  return lhs.size == rhs.size && lhs.points == rhs.points &&
+         lhs.blend == rhs.blend;
+}
+inline bool operator!=(const KeyPoints& lhs, const KeyPoints& rhs)
+{
+  return !(lhs == rhs);
+}
+
+inline constexpr glm::uvec2 c_default_grid_size{4u, 4u};
+
+/// Evenly spaced key points covering [-1, 1]^2, i.e. no distortion.
+KeyPoints makeDefaultKeyPoints(
+    const glm::uvec2& grid_size = c_default_grid_size);
+
+/// Files start with a "grid <columns> <rows>" line followed by one "x y"
+/// line per key point, files without the header hold a 4x4 grid. Edge
+/// blending follows as optional lines:
+///
+///   blend <left> <right> <bottom> <top>
+///   blend_curve <curve>
+///   gamma <gamma>
+///   brightness <brightness>
+///   mask "<image>"
+///
+/// A relative mask path is relative to the file.
+void storeKeyPoints(const KeyPoints& kps, const std::string_view& filename);
+KeyPoints loadKeyPoints(const std::string_view& filename);
+
+} // namespace warp
@@ -0,0 +1,404 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "Remap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define WARP_REMAP_X86 1
+#endif
+
+namespace warp {
+
+namespace {
+
+inline uint32_t fetch(const uint8_t* src, int index)
+{
+  uint32_t texel;
+  std::memcpy(&texel, src + 4 * static_cast<std::size_t>(index), 4);
+  return texel;
+}
+
+inline float channel(uint32_t texel, int c)
+{
+  return static_cast<float>((texel >> (8 * c)) & 0xff);
+}
+
+inline int wrap(int i, int size)
+{
+  i %= size;
+  return i < 0 ? i + size : i;
+}
+
+/// GL_REPEAT of a texture coordinate into [0, 1] before it is scaled to
+/// texels, so any coordinate stays within one texel of the texture. NaN and
+/// infinities sample the origin.
+inline float repeat(float t)
+{
+  const float f = t - std::floor(t);
+  return (f >= 0.f) ? std::min(f, 1.f) : 0.f;
+}
+
+inline void remapPixel(
+    float u,
+    float v,
+    const uint8_t* src,
+    int w,
+    int h,
+    uint8_t* dst)
+{
+  if (!(u >= 0.f))
+  {
+    dst[0] = dst[1] = dst[2] = 0;
+    dst[3] = 255;
+    return;
+  }
+
+  const float fx = repeat(u) * w - 0.5f;
+  const float fy = repeat(v) * h - 0.5f;
+  const float x0f = std::floor(fx);
+  const float y0f = std::floor(fy);
+  const float wx = fx - x0f;
+  const float wy = fy - y0f;
+  const int x0 = wrap(static_cast<int>(x0f), w);
+  const int y0 = wrap(static_cast<int>(y0f), h);
+  const int x1 = wrap(x0 + 1, w);
+  const int y1 = wrap(y0 + 1, h);
+
+  const uint32_t p00 = fetch(src, y0 * w + x0);
+  const uint32_t p10 = fetch(src, y0 * w + x1);
+  const uint32_t p01 = fetch(src, y1 * w + x0);
+  const uint32_t p11 = fetch(src, y1 * w + x1);
+
+  float rgba[4];
+  for (int c = 0; c < 4; ++c)
+  {
+    const float c00 = channel(p00, c);
+    const float c01 = channel(p01, c);
+    const float top = c00 + (channel(p10, c) - c00) * wx;
+    const float bot = c01 + (channel(p11, c) - c01) * wx;
+    rgba[c] = top + (bot - top) * wy;
+  }
+
+  const float a = rgba[3] * (1.f / 255.f);
+  dst[0] = static_cast<uint8_t>(std::lround(rgba[0] * a));
+  dst[1] = static_cast<uint8_t>(std::lround(rgba[1] * a));
+  dst[2] = static_cast<uint8_t>(std::lround(rgba[2] * a));
+  dst[3] = static_cast<uint8_t>(std::lround(rgba[3] * a + 255.f - rgba[3]));
+}
+
+#ifdef WARP_REMAP_X86
+
+inline __m128 channel(__m128i texels, int c)
+{
+  return _mm_cvtepi32_ps(
+      _mm_and_si128(_mm_srli_epi32(texels, 8 * c), _mm_set1_epi32(0xff)));
+}
+
+inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/// floor() without SSE4.1: truncate and step down for negative values,
+/// magnitudes from 2^23 on are whole already.
+inline __m128 floorPs(__m128 x)
+{
+  const __m128 whole = _mm_cmpge_ps(
+      _mm_andnot_ps(_mm_set1_ps(-0.f), x), _mm_set1_ps(8388608.f));
+  __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+  t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.f)));
+  return select(whole, x, t);
+}
+
+/// repeat() of four coordinates, max and min return their second operand
+/// for NaN.
+inline __m128 repeatPs(__m128 t)
+{
+  const __m128 f = _mm_max_ps(_mm_sub_ps(t, floorPs(t)), _mm_setzero_ps());
+  return _mm_min_ps(f, _mm_set1_ps(1.f));
+}
+
+void remapRowSse2(
+    const float* us,
+    const float* vs,
+    std::size_t count,
+    const uint8_t* src,
+    int w,
+    int h,
+    uint8_t* dst)
+{
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 half = _mm_set1_ps(.5f);
+  const __m128 full = _mm_set1_ps(255.f);
+  const __m128 width = _mm_set1_ps(static_cast<float>(w));
+  const __m128 height = _mm_set1_ps(static_cast<float>(h));
+
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 u = _mm_loadu_ps(us + i);
+    const __m128 covered = _mm_cmpge_ps(u, zero);
+
+    const __m128 fx = _mm_sub_ps(
+        _mm_mul_ps(repeatPs(_mm_and_ps(u, covered)), width), half);
+    const __m128 fy = _mm_sub_ps(
+        _mm_mul_ps(
+            repeatPs(_mm_and_ps(_mm_loadu_ps(vs + i), covered)), height),
+        half);
+    const __m128 x0f = floorPs(fx);
+    const __m128 y0f = floorPs(fy);
+    const __m128 wx = _mm_sub_ps(fx, x0f);
+    const __m128 wy = _mm_sub_ps(fy, y0f);
+
+    alignas(16) int32_t x0[4];
+    alignas(16) int32_t y0[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(x0), _mm_cvttps_epi32(x0f));
+    _mm_store_si128(reinterpret_cast<__m128i*>(y0), _mm_cvttps_epi32(y0f));
+
+    // Repeated coordinates are at most one texel off either side
+    alignas(16) uint32_t p[4][4];
+    for (int k = 0; k < 4; ++k)
+    {
+      const int x = x0[k] < 0 ? w - 1 : x0[k];
+      const int y = y0[k] < 0 ? h - 1 : y0[k];
+      const int xn = x + 1 < w ? x + 1 : 0;
+      const int yn = y + 1 < h ? y + 1 : 0;
+      p[0][k] = fetch(src, y * w + x);
+      p[1][k] = fetch(src, y * w + xn);
+      p[2][k] = fetch(src, yn * w + x);
+      p[3][k] = fetch(src, yn * w + xn);
+    }
+    const __m128i p00 = _mm_load_si128(reinterpret_cast<__m128i*>(p[0]));
+    const __m128i p10 = _mm_load_si128(reinterpret_cast<__m128i*>(p[1]));
+    const __m128i p01 = _mm_load_si128(reinterpret_cast<__m128i*>(p[2]));
+    const __m128i p11 = _mm_load_si128(reinterpret_cast<__m128i*>(p[3]));
+
+    __m128 rgba[4];
+    for (int c = 0; c < 4; ++c)
+    {
+      const __m128 c00 = channel(p00, c);
+      const __m128 c01 = channel(p01, c);
+      const __m128 top =
+          _mm_add_ps(c00, _mm_mul_ps(_mm_sub_ps(channel(p10, c), c00), wx));
+      const __m128 bot =
+          _mm_add_ps(c01, _mm_mul_ps(_mm_sub_ps(channel(p11, c), c01), wx));
+      rgba[c] = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bot, top), wy));
+    }
+
+    const __m128 a = _mm_mul_ps(rgba[3], _mm_set1_ps(1.f / 255.f));
+    rgba[0] = _mm_and_ps(covered, _mm_mul_ps(rgba[0], a));
+    rgba[1] = _mm_and_ps(covered, _mm_mul_ps(rgba[1], a));
+    rgba[2] = _mm_and_ps(covered, _mm_mul_ps(rgba[2], a));
+    rgba[3] = select(
+        covered,
+        _mm_add_ps(_mm_mul_ps(rgba[3], a), _mm_sub_ps(full, rgba[3])),
+        full);
+
+    __m128i out = _mm_cvtps_epi32(rgba[0]);
+    for (int c = 1; c < 4; ++c)
+    {
+      out = _mm_or_si128(out, _mm_slli_epi32(_mm_cvtps_epi32(rgba[c]), 8 * c));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), out);
+  }
+
+  remapRowScalar(us + i, vs + i, count - i, src, w, h, dst + 4 * i);
+}
+
+__attribute__((target("avx2,fma"))) inline __m256 channel(
+    __m256i texels,
+    int c)
+{
+  return _mm256_cvtepi32_ps(_mm256_and_si256(
+      _mm256_srli_epi32(texels, 8 * c), _mm256_set1_epi32(0xff)));
+}
+
+/// repeat() of eight coordinates, max returns its second operand for NaN.
+__attribute__((target("avx2,fma"))) inline __m256 repeatPs(__m256 t)
+{
+  const __m256 f =
+      _mm256_max_ps(_mm256_sub_ps(t, _mm256_floor_ps(t)), _mm256_setzero_ps());
+  return _mm256_min_ps(f, _mm256_set1_ps(1.f));
+}
+
+__attribute__((target("avx2,fma"))) void remapRowAvx2(
+    const float* us,
+    const float* vs,
+    std::size_t count,
+    const uint8_t* src,
+    int w,
+    int h,
+    uint8_t* dst)
+{
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 half = _mm256_set1_ps(.5f);
+  const __m256 full = _mm256_set1_ps(255.f);
+  const __m256 width = _mm256_set1_ps(static_cast<float>(w));
+  const __m256 height = _mm256_set1_ps(static_cast<float>(h));
+  const __m256i zeroi = _mm256_setzero_si256();
+  const __m256i onei = _mm256_set1_epi32(1);
+  const __m256i last_x = _mm256_set1_epi32(w - 1);
+  const __m256i last_y = _mm256_set1_epi32(h - 1);
+  const __m256i stride = _mm256_set1_epi32(w);
+  const int* texels = reinterpret_cast<const int*>(src);
+
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 u = _mm256_loadu_ps(us + i);
+    const __m256 covered = _mm256_cmp_ps(u, zero, _CMP_GE_OQ);
+
+    const __m256 fx =
+        _mm256_fmsub_ps(repeatPs(_mm256_and_ps(u, covered)), width, half);
+    const __m256 fy = _mm256_fmsub_ps(
+        repeatPs(_mm256_and_ps(_mm256_loadu_ps(vs + i), covered)),
+        height,
+        half);
+    const __m256 x0f = _mm256_floor_ps(fx);
+    const __m256 y0f = _mm256_floor_ps(fy);
+    const __m256 wx = _mm256_sub_ps(fx, x0f);
+    const __m256 wy = _mm256_sub_ps(fy, y0f);
+
+    // Repeated coordinates are at most one texel off either side
+    __m256i x0 = _mm256_cvttps_epi32(x0f);
+    __m256i y0 = _mm256_cvttps_epi32(y0f);
+    __m256i x1 = _mm256_add_epi32(x0, onei);
+    __m256i y1 = _mm256_add_epi32(y0, onei);
+    x0 = _mm256_blendv_epi8(x0, last_x, _mm256_cmpgt_epi32(zeroi, x0));
+    y0 = _mm256_blendv_epi8(y0, last_y, _mm256_cmpgt_epi32(zeroi, y0));
+    x1 = _mm256_blendv_epi8(x1, zeroi, _mm256_cmpgt_epi32(x1, last_x));
+    y1 = _mm256_blendv_epi8(y1, zeroi, _mm256_cmpgt_epi32(y1, last_y));
+
+    const __m256i row0 = _mm256_mullo_epi32(y0, stride);
+    const __m256i row1 = _mm256_mullo_epi32(y1, stride);
+    const __m256i p00 =
+        _mm256_i32gather_epi32(texels, _mm256_add_epi32(row0, x0), 4);
+    const __m256i p10 =
+        _mm256_i32gather_epi32(texels, _mm256_add_epi32(row0, x1), 4);
+    const __m256i p01 =
+        _mm256_i32gather_epi32(texels, _mm256_add_epi32(row1, x0), 4);
+    const __m256i p11 =
+        _mm256_i32gather_epi32(texels, _mm256_add_epi32(row1, x1), 4);
+
+    __m256 rgba[4];
+    for (int c = 0; c < 4; ++c)
+    {
+      const __m256 c00 = channel(p00, c);
+      const __m256 c01 = channel(p01, c);
+      const __m256 top =
+          _mm256_fmadd_ps(_mm256_sub_ps(channel(p10, c), c00), wx, c00);
+      const __m256 bot =
+          _mm256_fmadd_ps(_mm256_sub_ps(channel(p11, c), c01), wx, c01);
+      rgba[c] = _mm256_fmadd_ps(_mm256_sub_ps(bot, top), wy, top);
+    }
+
+    const __m256 a = _mm256_mul_ps(rgba[3], _mm256_set1_ps(1.f / 255.f));
+    rgba[0] = _mm256_and_ps(covered, _mm256_mul_ps(rgba[0], a));
+    rgba[1] = _mm256_and_ps(covered, _mm256_mul_ps(rgba[1], a));
+    rgba[2] = _mm256_and_ps(covered, _mm256_mul_ps(rgba[2], a));
+    rgba[3] = _mm256_blendv_ps(
+        full,
+        _mm256_fmadd_ps(rgba[3], a, _mm256_sub_ps(full, rgba[3])),
+        covered);
+
+    __m256i out = _mm256_cvtps_epi32(rgba[0]);
+    for (int c = 1; c < 4; ++c)
+    {
+      out = _mm256_or_si256(
+          out, _mm256_slli_epi32(_mm256_cvtps_epi32(rgba[c]), 8 * c));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4 * i), out);
+  }
+
+  remapRowScalar(us + i, vs + i, count - i, src, w, h, dst + 4 * i);
+}
+
+#endif // WARP_REMAP_X86
+
+} // namespace
+
+void remapRowScalar(
+    const float* us,
+    const float* vs,
+    std::size_t count,
+    const uint8_t* src,
+    int src_width,
+    int src_height,
+    uint8_t* dst)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    remapPixel(us[i], vs[i], src, src_width, src_height, dst + 4 * i);
+  }
+}
+
+RemapRowFn selectRemapRow()
+{
+#ifdef WARP_REMAP_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+  {
+    return remapRowAvx2;
+  }
+  return remapRowSse2;
+#else
+  return remapRowScalar;
+#endif
+}
+
+std::vector<RemapRowFn> supportedRemapRows()
+{
+  std::vector<RemapRowFn> fns = {remapRowScalar};
+#ifdef WARP_REMAP_X86
+  fns.push_back(remapRowSse2);
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+  {
+    fns.push_back(remapRowAvx2);
+  }
+#endif
+  return fns;
+}
+
+const char* remapRowName(RemapRowFn fn)
+{
+#ifdef WARP_REMAP_X86
+  if (fn == remapRowAvx2)
+  {
+    return "avx2";
+  }
+  if (fn == remapRowSse2)
+  {
+    return "sse2";
+  }
+#endif
+  return (fn == remapRowScalar) ? "scalar" : "unknown";
+}
+
+} // namespace warp
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace warp {
+
+/// Samples an RGBA8 source like GL_LINEAR with GL_REPEAT does.
+///
+/// @p us and @p vs hold normalized texture coordinates per output pixel, a
+/// negative or NaN u marks a pixel not covered by the mesh which gets opaque
+/// black. Coordinates outside [0, 1] repeat, whatever their magnitude.
+/// Sampled colors are blended over opaque black the same way the GLES2 path
+/// does with GL_SRC_ALPHA / GL_ONE_MINUS_SRC_ALPHA.
+using RemapRowFn = void (*)(
+    const float* us,
+    const float* vs,
+    std::size_t count,
+    const uint8_t* src,
+    int src_width,
+    int src_height,
+    uint8_t* dst);
+
+void remapRowScalar(
+    const float* us,
+    const float* vs,
+    std::size_t count,
+    const uint8_t* src,
+    int src_width,
+    int src_height,
+    uint8_t* dst);
+
+/// Picks the widest implementation the running CPU supports.
+RemapRowFn selectRemapRow();
+/// Every implementation the running CPU supports, remapRowScalar() first.
+std::vector<RemapRowFn> supportedRemapRows();
+const char* remapRowName(RemapRowFn fn);
+
+} // namespace warp
@@ -0,0 +1,258 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+namespace warp {
+
+inline constexpr char c_img_vshader_src[] = R"(
+  precision highp float;
+  attribute vec3 a_pos;
+  attribute vec2 a_tex0;
+  uniform mat4 u_mvp;
+  varying vec2 v_tex0;
+  varying vec2 v_out;
+
+  void main() {
+    gl_Position = u_mvp * vec4(a_pos, 1.0);
+    v_tex0 = a_tex0;
+    v_out = gl_Position.xy / gl_Position.w * 0.5 + 0.5;
+  }
+)";
+
+// Spline surface evaluated in the vertex shader, see warp::CSplineSurface.
+// The control net comes packed two points per vector, NET_VECTORS is
+// defined in front by warp::surfaceVertexShader().
+inline constexpr char c_surface_src[] = R"(
+  precision highp float;
+  uniform vec2 u_patches;
+  uniform vec4 u_net[NET_VECTORS];
+
+  vec2 netPoint(int index) {
+    vec4 pair = u_net[index / 2];
+    return (index - index / 2 * 2 == 0) ? pair.xy : pair.zw;
+  }
+
+  vec4 bernstein(float t) {
+    float s = 1.0 - t;
+    return vec4(s * s * s, 3.0 * t * s * s, 3.0 * t * t * s, t * t * t);
+  }
+
+  vec2 evaluateSurface(vec2 uv) {
+    vec2 scaled = uv * u_patches;
+    vec2 cell = clamp(floor(scaled), vec2(0.0), u_patches - 1.0);
+    vec2 t = scaled - cell;
+    vec4 bu = bernstein(t.x);
+    vec4 bv = bernstein(t.y);
+
+    int width = int(u_patches.x + 0.5) * 3 + 1;
+    int row = int(cell.y + 0.5) * 3 * width + int(cell.x + 0.5) * 3;
+    vec2 point = vec2(0.0);
+    for (int b = 0; b < 4; ++b) {
+      vec2 along = netPoint(row) * bu.x + netPoint(row + 1) * bu.y +
+                   netPoint(row + 2) * bu.z + netPoint(row + 3) * bu.w;
+      point += along * bv[b];
+      row += width;
+    }
+    return point;
+  }
+)";
+
+// Goes after c_surface_src, draws the static parameter grid of
+// warp::generateParameterMesh() with either of the warp or the debug
+// fragment shaders
+inline constexpr char c_surface_vshader_src[] = R"(
+  attribute vec2 a_tex0;
+  uniform mat4 u_mvp;
+  uniform float u_pnt_sz;
+  varying vec2 v_tex0;
+  varying vec2 v_out;
+
+  void main() {
+    vec2 pos = evaluateSurface(a_tex0);
+    gl_PointSize = u_pnt_sz;
+    gl_Position = u_mvp * vec4(pos, 0.0, 1.0);
+    v_tex0 = a_tex0;
+    v_out = gl_Position.xy / gl_Position.w * 0.5 + 0.5;
+  }
+)";
+
+// Sources of the warp fragment shaders, one of them goes in front of
+// c_img_fshader_src or c_lut_fshader_src to define sampleSource()
+
+inline constexpr char c_rgba_source_src[] = R"(
+  precision highp float;
+  uniform sampler2D u_tex;
+
+  vec4 sampleSource(vec2 uv) {
+    return texture2D(u_tex, uv);
+  }
+)";
+
+inline constexpr char c_i420_source_src[] = R"(
+  precision highp float;
+  uniform sampler2D u_tex;
+  uniform sampler2D u_tex_u;
+  uniform sampler2D u_tex_v;
+  uniform mat3 u_yuv_matrix;
+  uniform vec3 u_yuv_offset;
+
+  vec4 sampleSource(vec2 uv) {
+    vec3 yuv = vec3(
+        texture2D(u_tex, uv).r,
+        texture2D(u_tex_u, uv).r,
+        texture2D(u_tex_v, uv).r);
+    return vec4(u_yuv_matrix * (yuv - u_yuv_offset), 1.0);
+  }
+)";
+
+inline constexpr char c_nv12_source_src[] = R"(
+  precision highp float;
+  uniform sampler2D u_tex;
+  uniform sampler2D u_tex_uv;
+  uniform mat3 u_yuv_matrix;
+  uniform vec3 u_yuv_offset;
+
+  vec4 sampleSource(vec2 uv) {
+    vec3 yuv = vec3(texture2D(u_tex, uv).r, texture2D(u_tex_uv, uv).ra);
+    return vec4(u_yuv_matrix * (yuv - u_yuv_offset), 1.0);
+  }
+)";
+
+// Edge blending of projector overlaps, see warp::EdgeBlend. Goes in front
+// of the warp fragment shaders as well, v_out is the position on the
+// output in [0, 1]^2, after zoom and pan.
+inline constexpr char c_blend_src[] = R"(
+  precision highp float;
+  uniform vec4 u_blend_widths;
+  uniform float u_blend_curve;
+  uniform float u_blend_gamma;
+  uniform float u_brightness;
+  uniform sampler2D u_mask;
+  uniform float u_mask_weight;
+  varying vec2 v_out;
+
+  float blendRamp(float t) {
+    t = clamp(t, 0.0, 1.0);
+    return (t < 0.5) ? 0.5 * pow(2.0 * t, u_blend_curve)
+                     : 1.0 - 0.5 * pow(2.0 - 2.0 * t, u_blend_curve);
+  }
+
+  vec4 blendEdges(vec4 color) {
+    vec4 t = vec4(v_out.x, 1.0 - v_out.x, v_out.y, 1.0 - v_out.y) /
+             max(u_blend_widths, vec4(1e-6));
+    float weight = blendRamp(t.x) * blendRamp(t.y) * blendRamp(t.z) *
+                   blendRamp(t.w);
+    weight = pow(weight, 1.0 / u_blend_gamma) * u_brightness *
+             mix(1.0, texture2D(u_mask, v_out).r, u_mask_weight);
+    return vec4(color.rgb * weight, color.a);
+  }
+)";
+
+inline constexpr char c_img_fshader_src[] = R"(
+  precision highp float;
+  varying vec2 v_tex0;
+
+  vec4 sampleSource(vec2 uv);
+  vec4 blendEdges(vec4 color);
+
+  void main() {
+    gl_FragColor = blendEdges(sampleSource(v_tex0));
+  }
+)";
+
+inline constexpr char c_lut_fshader_src[] = R"(
+  precision highp float;
+  uniform sampler2D u_lut;
+  uniform float u_lut_scale;
+  varying vec2 v_tex0;
+
+  vec4 sampleSource(vec2 uv);
+  vec4 blendEdges(vec4 color);
+
+  void main() {
+    // (u, v) pairs are stored as little endian uint16, see warp::LutHeader
+    vec4 lut = floor(texture2D(u_lut, v_tex0) * 255.0 + 0.5);
+    vec2 uv = vec2(lut.r + lut.g * 256.0, lut.b + lut.a * 256.0);
+    if (uv.x > 65534.5) {
+      discard;
+    }
+    gl_FragColor = blendEdges(sampleSource(uv / u_lut_scale));
+  }
+)";
+
+// Calibration pattern drawn into an offscreen source: a checkerboard with
+// a line grid, a red frame and a green circle, tinted by position so the
+// orientation shows after warping
+inline constexpr char c_pattern_fshader_src[] = R"(
+  precision highp float;
+  uniform vec2 u_size;
+  varying vec2 v_tex0;
+
+  void main() {
+    vec2 px = v_tex0 * u_size;
+    vec2 cell = floor(v_tex0 * 8.0);
+    vec3 color = mix(vec3(0.2), vec3(0.45), mod(cell.x + cell.y, 2.0));
+    color *= vec3(0.5 + 0.5 * v_tex0, 1.0);
+
+    vec2 line = abs(fract(v_tex0 * 16.0 + 0.5) - 0.5) * u_size / 16.0;
+    if (min(line.x, line.y) < 1.0) {
+      color = vec3(1.0);
+    }
+    float radius = 0.4 * min(u_size.x, u_size.y);
+    if (abs(length(px - 0.5 * u_size) - radius) < 1.5) {
+      color = vec3(0.0, 1.0, 0.0);
+    }
+    vec2 edge = min(px, u_size - px);
+    if (min(edge.x, edge.y) < 3.0) {
+      color = vec3(1.0, 0.0, 0.0);
+    }
+    gl_FragColor = vec4(color, 1.0);
+  }
+)";
+
+inline constexpr char c_dbg_vshader_src[] = R"(
+  attribute vec3 a_pos;
+  attribute vec2 a_tex0;
+  uniform mat4 u_mvp;
+  uniform float u_pnt_sz;
+
+  void main() {
+    gl_PointSize = u_pnt_sz;
+    gl_Position = u_mvp * vec4(a_pos, 1.0);
+  }
+)";
+
+inline constexpr char c_dbg_fshader_src[] = R"(
+  precision mediump float;
+  uniform sampler2D u_tex;
+  uniform vec4 u_col;
+  varying vec2 v_tex0;
+
+  void main() {
+    gl_FragColor = u_col;
+  }
+)";
+
+} // namespace warp
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "SurfaceShader.hpp"
+
+#include <GLES2/gl2.h>
+#include <algorithm>
+#include <glm/vec4.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace warp {
+
+namespace {
+
+/// u_mvp, u_pnt_sz and u_patches, with room to spare.
+constexpr GLint c_reserved_vectors = 8;
+/// Bounds the array of drivers with plenty of uniforms, 7x7 key points
+/// need 361 control points.
+constexpr GLint c_max_net_vectors = 256;
+
+std::size_t netVectors()
+{
+  GLint max_vectors = 0;
+  glGetIntegerv(GL_MAX_VERTEX_UNIFORM_VECTORS, &max_vectors);
+  return static_cast<std::size_t>(std::clamp(
+      max_vectors - c_reserved_vectors, GLint(1), c_max_net_vectors));
+}
+
+thread_local std::vector<glm::vec4> t_packed;
+
+} // namespace
+
+std::size_t surfaceNetCapacity()
+{
+  return 2 * netVectors();
+}
+
+bool canEvaluateSurface(const glm::uvec2& grid_size)
+{
+  const glm::uvec2 net_size = (grid_size - 1u) * 3u + 1u;
+  return std::size_t(net_size.x) * net_size.y <= surfaceNetCapacity();
+}
+
+std::string surfaceVertexShader(const std::string_view& main_src)
+{
+  std::string source =
+      "#define NET_VECTORS " + std::to_string(netVectors()) + "\n";
+  source.append(c_surface_src);
+  source.append(main_src);
+  return source;
+}
+
+void setSurfaceUniforms(
+    gles2::CShaderProgram& program,
+    const CSplineSurface& surface)
+{
+  const std::vector<glm::vec2>& net = surface.net();
+  if (net.size() > surfaceNetCapacity())
+  {
+    throw std::invalid_argument("control net is too big for the shader");
+  }
+
+  t_packed.resize((net.size() + 1) / 2);
+  for (std::size_t i = 0; i < net.size(); i += 2)
+  {
+    const glm::vec2 next = (i + 1 < net.size()) ? net[i + 1] : glm::vec2(0.f);
+    t_packed[i / 2] = glm::vec4(net[i].x, net[i].y, next.x, next.y);
+  }
+  program.setUniform("u_patches", glm::vec2(surface.patches()));
+  program.setUniform(
+      program.uniform<glm::vec4>("u_net"), t_packed.data(), t_packed.size());
+}
+
+} // namespace warp
@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+#include <string>
+#include <string_view>
+
+#include "CSplineSurface.hpp"
+#include "Shaders.hpp"
+#include "gles2/CShaderProgram.hpp"
+
+namespace warp {
+
+/// Control points the surface shaders hold, two per uniform vector of the
+/// vertex stage less a few for the other uniforms.
+std::size_t surfaceNetCapacity();
+
+/// Whether the control net of a key points grid of @p grid_size fits into
+/// surfaceNetCapacity(), larger grids are sampled on the CPU.
+bool canEvaluateSurface(const glm::uvec2& grid_size);
+
+/// Vertex shader evaluating the spline surface at a_tex0 of the
+/// generateParameterMesh() vertices, @p main_src calls evaluateSurface().
+std::string surfaceVertexShader(
+    const std::string_view& main_src = c_surface_vshader_src);
+
+/// Uploads the control net of @p surface to a program built with
+/// surfaceVertexShader(), the program has to be in use. Throws
+/// std::invalid_argument if the net is over surfaceNetCapacity().
+void setSurfaceUniforms(
+    gles2::CShaderProgram& program,
+    const CSplineSurface& surface);
+
+} // namespace warp
@@ -0,0 +1,365 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "Tessellation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/geometric.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace warp {
+
+namespace {
+
+constexpr std::size_t c_max_breakpoints = 256;
+constexpr float c_min_interval = 1e-4f;
+
+// Refinement samples the error on a lattice of c_steps per cell side. The
+// result is measured on lattices doubling from there until two doublings
+// in a row change the error by less than c_converged of it or
+// c_min_change pixels, up to c_max_steps, since a peak between lattice
+// points shows up late.
+constexpr int c_steps = 4;
+constexpr int c_max_steps = 64;
+constexpr float c_converged = 1e-3f;
+constexpr float c_min_change = 1e-3f;
+constexpr float c_measured_share = .5f;
+// Tries with a lower lattice target when the measured error is over
+constexpr int c_max_tries = 4;
+
+struct CellError
+{
+  float error;
+  /// How far the surface bends away from the cell edges in each direction
+  float along_u;
+  float along_v;
+};
+
+// Distance between the surface and the triangles of the cell
+// [u0, u1] x [v0, v1], split along its (u1, v0) - (u0, v1) diagonal like
+// the strips of generateGridIndices(). @p scale takes clip space to pixels.
+CellError sampleCellError(
+    const CSplineSurface& surface,
+    const glm::vec2& scale,
+    float u0,
+    float u1,
+    float v0,
+    float v1,
+    int steps)
+{
+  thread_local std::vector<glm::vec2> t_samples;
+  const int side = steps + 1;
+  t_samples.resize(side * side);
+  auto sample = [&](int k, int l) -> glm::vec2& {
+    return t_samples[k * side + l];
+  };
+  for (int k = 0; k <= steps; ++k)
+  {
+    for (int l = 0; l <= steps; ++l)
+    {
+      sample(k, l) = surface.evaluate(glm::vec2(
+          u0 + (u1 - u0) * k / steps, v0 + (v1 - v0) * l / steps));
+    }
+  }
+  const glm::vec2 p00 = sample(0, 0);
+  const glm::vec2 p10 = sample(steps, 0);
+  const glm::vec2 p01 = sample(0, steps);
+  const glm::vec2 p11 = sample(steps, steps);
+
+  CellError cell{0.f, 0.f, 0.f};
+  for (int k = 0; k <= steps; ++k)
+  {
+    for (int l = 0; l <= steps; ++l)
+    {
+      const float s = static_cast<float>(k) / steps;
+      const float t = static_cast<float>(l) / steps;
+      const glm::vec2 linear =
+          (k + l <= steps)
+              ? p00 + (p10 - p00) * s + (p01 - p00) * t
+              : p11 + (p01 - p11) * (1.f - s) + (p10 - p11) * (1.f - t);
+      cell.error =
+          std::max(cell.error, glm::length((sample(k, l) - linear) * scale));
+    }
+  }
+  for (int m = 0; m <= steps; ++m)
+  {
+    const glm::vec2 mid_u = (sample(0, m) + sample(steps, m)) * 0.5f;
+    const glm::vec2 mid_v = (sample(m, 0) + sample(m, steps)) * 0.5f;
+    cell.along_u = std::max(
+        cell.along_u, glm::length((sample(steps / 2, m) - mid_u) * scale));
+    cell.along_v = std::max(
+        cell.along_v, glm::length((sample(m, steps / 2) - mid_v) * scale));
+  }
+  return cell;
+}
+
+CellError cellError(
+    const CSplineSurface& surface,
+    const glm::vec2& scale,
+    float u0,
+    float u1,
+    float v0,
+    float v1)
+{
+  return sampleCellError(surface, scale, u0, u1, v0, v1, c_steps);
+}
+
+float measuredCellError(
+    const CSplineSurface& surface,
+    const glm::vec2& scale,
+    float u0,
+    float u1,
+    float v0,
+    float v1)
+{
+  float error = cellError(surface, scale, u0, u1, v0, v1).error;
+  int stable = 0;
+  for (int steps = 2 * c_steps; steps <= c_max_steps && stable < 2;
+       steps *= 2)
+  {
+    const float finer =
+        sampleCellError(surface, scale, u0, u1, v0, v1, steps).error;
+    const float change = std::abs(finer - error);
+    stable = (change <= std::max(c_converged * finer, c_min_change))
+                 ? stable + 1
+                 : 0;
+    error = std::max(error, finer);
+  }
+  return error;
+}
+
+// Every patch boundary, the coarsest grid refinement starts from
+std::vector<float> patchBreakpoints(unsigned patches)
+{
+  std::vector<float> breakpoints(patches + 1);
+  for (unsigned i = 0; i <= patches; ++i)
+  {
+    breakpoints[i] = static_cast<float>(i) / patches;
+  }
+  return breakpoints;
+}
+
+// Halves the intervals marked in @p split while the grid has room, returns
+// whether any was
+bool subdivide(std::vector<float>& breakpoints, const std::vector<bool>& split)
+{
+  std::vector<float> refined;
+  refined.reserve(c_max_breakpoints);
+  std::size_t room = c_max_breakpoints - breakpoints.size();
+  for (std::size_t k = 0; k + 1 < breakpoints.size(); ++k)
+  {
+    refined.push_back(breakpoints[k]);
+    const float width = breakpoints[k + 1] - breakpoints[k];
+    if (split[k] && room > 0 && width > 2 * c_min_interval)
+    {
+      refined.push_back(breakpoints[k] + width * 0.5f);
+      --room;
+    }
+  }
+  refined.push_back(breakpoints.back());
+  const bool grown = refined.size() != breakpoints.size();
+  breakpoints = std::move(refined);
+  return grown;
+}
+
+// Drops the inner breakpoints of @p along whose removal keeps every merged
+// cell across @p across within the tolerance. Merges grow greedily, so
+// flat stretches end up as one interval.
+void merge(
+    const CSplineSurface& surface,
+    const glm::vec2& scale,
+    float tolerance,
+    std::vector<float>& along,
+    const std::vector<float>& across,
+    bool along_u)
+{
+  for (std::size_t k = 1; k + 1 < along.size();)
+  {
+    bool fits = true;
+    for (std::size_t m = 0; fits && m + 1 < across.size(); ++m)
+    {
+      const CellError cell =
+          along_u ? cellError(
+                        surface,
+                        scale,
+                        along[k - 1],
+                        along[k + 1],
+                        across[m],
+                        across[m + 1])
+                  : cellError(
+                        surface,
+                        scale,
+                        across[m],
+                        across[m + 1],
+                        along[k - 1],
+                        along[k + 1]);
+      fits = cell.error <= tolerance;
+    }
+    if (fits)
+    {
+      along.erase(along.begin() + k);
+    }
+    else
+    {
+      ++k;
+    }
+  }
+}
+
+// Splits cells over @p target on the sampling lattice, then merges back
+// what stays within it
+void refine(
+    const CSplineSurface& surface,
+    const glm::vec2& scale,
+    float target,
+    std::vector<float>& us,
+    std::vector<float>& vs)
+{
+  // Splits go across the direction the surface bends in, both when it
+  // twists without bending
+  while (true)
+  {
+    std::vector<bool> split_u(us.size() - 1);
+    std::vector<bool> split_v(vs.size() - 1);
+    bool over = false;
+    for (std::size_t i = 0; i + 1 < us.size(); ++i)
+    {
+      for (std::size_t j = 0; j + 1 < vs.size(); ++j)
+      {
+        const CellError cell =
+            cellError(surface, scale, us[i], us[i + 1], vs[j], vs[j + 1]);
+        if (cell.error > target)
+        {
+          over = true;
+          split_u[i] = split_u[i] || cell.along_u >= 0.5f * cell.along_v;
+          split_v[j] = split_v[j] || cell.along_v >= 0.5f * cell.along_u;
+        }
+      }
+    }
+    if (!over)
+    {
+      break;
+    }
+    const bool grown_u = subdivide(us, split_u);
+    const bool grown_v = subdivide(vs, split_v);
+    if (!grown_u && !grown_v)
+    {
+      break;
+    }
+  }
+
+  merge(surface, scale, target, us, vs, true);
+  merge(surface, scale, target, vs, us, false);
+}
+
+} // namespace
+
+Tessellation tessellateSurface(
+    const CSplineSurface& surface,
+    const glm::uvec2& viewport,
+    float tolerance)
+{
+  if (!(tolerance > 0.f))
+  {
+    throw std::invalid_argument("tessellation tolerance must be positive");
+  }
+
+  const glm::vec2 scale = glm::vec2(viewport) * 0.5f;
+  Tessellation tessellation{};
+
+  // The lattice misses peaks between its points, a grid measuring over
+  // the tolerance is refined again for a target lowered by what it missed
+  float target = tolerance;
+  for (int tries = 0; tries < c_max_tries; ++tries)
+  {
+    tessellation = {
+        patchBreakpoints(surface.patches().x),
+        patchBreakpoints(surface.patches().y),
+        0.f};
+    refine(surface, scale, target, tessellation.us, tessellation.vs);
+
+    // Worst cells on the lattice first, one whose lattice error is under
+    // c_measured_share of the maximum would need a peak that much higher
+    // between the lattice points to matter
+    const std::vector<float>& us = tessellation.us;
+    const std::vector<float>& vs = tessellation.vs;
+    std::vector<std::pair<float, glm::uvec2>> cells;
+    for (unsigned i = 0; i + 1 < us.size(); ++i)
+    {
+      for (unsigned j = 0; j + 1 < vs.size(); ++j)
+      {
+        cells.emplace_back(
+            cellError(surface, scale, us[i], us[i + 1], vs[j], vs[j + 1])
+                .error,
+            glm::uvec2(i, j));
+      }
+    }
+    std::sort(cells.begin(), cells.end(), [](auto&& lhs, auto&& rhs) {
+      return lhs.first > rhs.first;
+    });
+    const float lattice_error = cells.front().first;
+    for (auto&& [error, cell] : cells)
+    {
+      if (error < c_measured_share * tessellation.max_error)
+      {
+        break;
+      }
+      const unsigned i = cell.x;
+      const unsigned j = cell.y;
+      tessellation.max_error = std::max(
+          tessellation.max_error,
+          measuredCellError(
+              surface, scale, us[i], us[i + 1], vs[j], vs[j + 1]));
+    }
+    if (tessellation.max_error <= tolerance || !(lattice_error > 0.f))
+    {
+      break;
+    }
+    target = std::min(target, lattice_error) * 0.99f * tolerance /
+             tessellation.max_error;
+  }
+  return tessellation;
+}
+
+void generateTessellationVertices(
+    const CSplineSurface& surface,
+    const Tessellation& tessellation,
+    gles2::CMesh::Vertices& vertices)
+{
+  vertices.resize(tessellation.us.size() * tessellation.vs.size());
+  gles2::CMesh::Vertex* out = vertices.data();
+  for (float u : tessellation.us)
+  {
+    for (float v : tessellation.vs)
+    {
+      const glm::vec2 uv(u, v);
+      *out++ = {glm::vec3(surface.evaluate(uv), 0.f), uv};
+    }
+  }
+}
+
+} // namespace warp
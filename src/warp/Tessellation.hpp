@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <vector>
+
+#include "CSplineSurface.hpp"
+#include "gles2/CMesh.hpp"
+
+namespace warp {
+
+/// Vertex grid at every (us[i], vs[j]), which generateGridIndices() of
+/// size() triangulates. Rows and columns go wherever any patch needs them,
+/// so the grid has no T-junctions and never cracks. The price is that a
+/// split runs across the whole surface: one bent patch refines its entire
+/// row and column of patches, flat or not.
+struct Tessellation
+{
+  std::vector<float> us;
+  std::vector<float> vs;
+  /// Largest distance between the triangles and the surface in pixels,
+  /// measured on lattices doubling in density until it stops changing.
+  float max_error;
+
+  glm::uvec2 size() const
+  {
+    return glm::uvec2(us.size(), vs.size());
+  }
+};
+
+/// Coarsest grid found whose triangles stay within @p tolerance pixels of
+/// @p surface drawn to @p viewport. Cells over the bound are split where
+/// the surface bends, then every split the bound holds without is merged
+/// back. Grids stop growing at 256 vertices per side, a max_error above
+/// @p tolerance tells that wasn't enough.
+Tessellation tessellateSurface(
+    const CSplineSurface& surface,
+    const glm::uvec2& viewport,
+    float tolerance);
+
+/// Fills @p vertices with the grid, column by column, reusing its storage.
+void generateTessellationVertices(
+    const CSplineSurface& surface,
+    const Tessellation& tessellation,
+    gles2::CMesh::Vertices& vertices);
+
+} // namespace warp
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <GLES2/gl2.h>
+#include <cstdint>
+#include <glm/gtx/transform.hpp>
+#include <vector>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CFrameBuffer.hpp"
+#include "gles2/CMesh.hpp"
+#include "gles2/CShaderProgram.hpp"
+#include "gles2/CTexture2D.hpp"
+#include "video/SourceShader.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/EdgeBlend.hpp"
+#include "warp/Shaders.hpp"
+
+namespace test {
+
+namespace {
+
+constexpr glm::uvec2 c_target_size{64u, 64u};
+
+/// Red of the pixel at @p x on the middle row, after drawing the white
+/// image scaled by @p zoom.
+int drawRed(
+    gles2::CShaderProgram& program,
+    gles2::CMesh& quad,
+    float zoom,
+    unsigned x)
+{
+  glClear(GL_COLOR_BUFFER_BIT);
+  program.setUniform("u_mvp", glm::scale(glm::vec3(zoom)));
+  quad.draw(program);
+  uint8_t pixel[4] = {};
+  glReadPixels(
+      x, c_target_size.y / 2, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+  return pixel[0];
+}
+
+} // namespace
+
+void testBlend(CChecker& checker)
+{
+  if (!checker.begin("blend"))
+  {
+    return;
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  {
+    const std::vector<uint8_t> white(4 * 4 * 4, 255);
+    gles2::CTexture2D source(glm::uvec2(4, 4), GL_RGBA, white.data());
+    gles2::CTexture2D target(c_target_size, GL_RGBA);
+    gles2::CFrameBuffer frame_buffer(target);
+    gles2::CFrameBuffer::bind(frame_buffer);
+    glViewport(0, 0, c_target_size.x, c_target_size.y);
+    glClearColor(0.f, 0.f, 0.f, 1.f);
+
+    gles2::CShaderProgram program(
+        warp::c_img_vshader_src,
+        video::sourceFragmentShader(
+            video::PixelFormat::Rgba, warp::c_img_fshader_src));
+    gles2::CShaderProgram::use(program);
+    video::setSourceUniforms(program, video::YuvMatrix::Bt601);
+    warp::EdgeBlend blend;
+    blend.widths.x = .25f;
+    warp::setEdgeBlendUniforms(program, blend, false);
+    gles2::CTexture2D::bind(source);
+    gles2::CMesh quad = warp::generateQuadMesh();
+
+    // The ramp stays on the output whatever the zoom: at 10% of the width
+    // it fades, at 30% it is past the ramp even though the zoomed out
+    // image starts at 25%
+    const unsigned inside = c_target_size.x / 10;
+    const unsigned past = c_target_size.x * 3 / 10;
+    checker.expect(
+        drawRed(program, quad, 1.f, inside) < 200, "ramp fades unzoomed");
+    checker.expect(
+        drawRed(program, quad, 2.f, inside) < 200, "ramp fades zoomed in");
+    checker.expect(
+        drawRed(program, quad, .5f, past) == 255,
+        "no ramp past it zoomed out");
+    gles2::CFrameBuffer::unbind();
+  }
+  egl::CContext::release(context);
+}
+
+} // namespace test
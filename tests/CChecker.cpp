@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include "CChecker.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+namespace test {
+
+CChecker::CChecker(std::string filter)
+  : m_filter(std::move(filter))
+  , m_checks(0)
+  , m_failures(0)
+{
+}
+
+bool CChecker::begin(const std::string& name)
+{
+  if (!m_filter.empty() && name.find(m_filter) == std::string::npos)
+  {
+    return false;
+  }
+  m_suite = name;
+  return true;
+}
+
+bool CChecker::expect(bool passed, const std::string& what)
+{
+  ++m_checks;
+  if (!passed)
+  {
+    ++m_failures;
+    std::cerr << "FAIL " << m_suite << ": " << what << std::endl;
+  }
+  return passed;
+}
+
+bool CChecker::expectNear(
+    double actual,
+    double expected,
+    double tolerance,
+    const std::string& what)
+{
+  const bool passed = std::abs(actual - expected) <= tolerance;
+  return expect(
+      passed,
+      what + " is " + std::to_string(actual) + ", expected " +
+          std::to_string(expected) + " +- " + std::to_string(tolerance));
+}
+
+} // namespace test
@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace test {
+
+/// Minimal check driver: suites record expectations, failed ones are
+/// printed with the suite name and fail the run.
+class CChecker
+{
+public:
+  explicit CChecker(std::string filter);
+
+  /// Whether the suite @p name runs, it prefixes the failures reported
+  /// until the next begin().
+  bool begin(const std::string& name);
+
+  /// Returns @p passed, a failure described by @p what is recorded when not.
+  bool expect(bool passed, const std::string& what);
+  bool expectNear(
+      double actual,
+      double expected,
+      double tolerance,
+      const std::string& what);
+
+  std::size_t checks() const { return m_checks; }
+  std::size_t failures() const { return m_failures; }
+
+private:
+  std::string m_filter;
+  std::string m_suite;
+  std::size_t m_checks;
+  std::size_t m_failures;
+};
+
+} // namespace test
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Suites.hpp"
+#include "app/CFileWatcher.hpp"
+
+namespace test {
+
+namespace {
+
+constexpr auto c_settle = std::chrono::milliseconds(50);
+/// Long enough for the watcher thread to settle a file, with margin.
+constexpr auto c_wait = std::chrono::milliseconds(300);
+
+std::size_t changes(app::CFileWatcher& watcher)
+{
+  std::this_thread::sleep_for(c_wait);
+  return watcher.takeChanged().size();
+}
+
+} // namespace
+
+void testFileWatcher(CChecker& checker)
+{
+  if (!checker.begin("file_watcher"))
+  {
+    return;
+  }
+
+  const std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "file_watcher_test";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  const std::filesystem::path path = dir / "kps.hcd";
+  std::ofstream(path) << "0\n";
+
+  app::CFileWatcher watcher({path.string()}, {}, c_settle);
+  {
+    // A writer pausing longer than the settle time, halfway through
+    std::ofstream file(path);
+    file << "1" << std::flush;
+    checker.expect(changes(watcher) == 0, "open file is not taken");
+    file << "\n" << std::flush;
+    file.close();
+    checker.expect(changes(watcher) == 1, "closed file is taken");
+  }
+  {
+    std::ofstream(dir / "kps.tmp") << "2\n";
+    checker.expect(changes(watcher) == 0, "other files are ignored");
+    std::filesystem::rename(dir / "kps.tmp", path);
+    checker.expect(changes(watcher) == 1, "renamed file is taken");
+  }
+  {
+    // Bursts of complete writes make one change
+    for (int i = 0; i < 5; ++i)
+    {
+      std::ofstream(path) << i << "\n";
+    }
+    checker.expect(changes(watcher) == 1, "burst is taken once");
+    checker.expect(changes(watcher) == 0, "burst is taken once only");
+  }
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace test
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Suites.hpp"
+#include "app/CImageCache.hpp"
+#include "egl/CContext.hpp"
+#include "warp/Image.hpp"
+
+namespace test {
+
+namespace {
+
+constexpr std::size_t c_num_images = 5;
+
+/// Gives the decoding thread up to a few seconds.
+bool waitDecoded(app::CImageCache& cache)
+{
+  for (int i = 0; i < 500 && !cache.selectedDecoded(); ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return cache.selectedDecoded();
+}
+
+} // namespace
+
+void testImageCache(CChecker& checker)
+{
+  if (!checker.begin("image_cache"))
+  {
+    return;
+  }
+
+  const std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "image_cache_test";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  const warp::Image image{
+      glm::uvec2(8, 8), 4, std::vector<uint8_t>(8 * 8 * 4, 128)};
+  std::vector<std::string> paths;
+  for (std::size_t i = 0; i < c_num_images; ++i)
+  {
+    paths.push_back((dir / (std::to_string(i) + ".png")).string());
+    warp::saveImage(image, paths.back());
+  }
+  paths.back() = (dir / "missing.png").string();
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  {
+    std::atomic<int> notified{0};
+    app::CImageCache cache(paths, 1 << 20, false, [&] { ++notified; }, 1);
+
+    checker.expect(
+        cache.get(0) == nullptr, "undecoded image is queued, not decoded");
+    checker.expect(waitDecoded(cache), "selected image gets decoded");
+    checker.expect(notified > 0, "decoded selection is notified");
+    const gles2::CTexture2D* first = cache.get(0);
+    checker.expect(first != nullptr, "decoded image is uploaded");
+    checker.expect(!cache.selectedDecoded(), "uploaded image is seen");
+
+    // Image 2 isn't next to 0, the first one stays until it is decoded
+    checker.expect(cache.get(2) == first, "image before stays shown");
+    checker.expect(waitDecoded(cache), "next selection gets decoded");
+    const gles2::CTexture2D* third = cache.get(2);
+    checker.expect(
+        third != nullptr && third != first, "next selection is shown");
+
+    // The missing one is next to image 0, it may have failed already
+    cache.get(c_num_images - 1);
+    waitDecoded(cache);
+    checker.expect(
+        cache.get(c_num_images - 1) == nullptr, "missing file shows nothing");
+  }
+  egl::CContext::release(context);
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace test
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Suites.hpp"
+#include "warp/CLutFile.hpp"
+#include "warp/CUvMap.hpp"
+
+namespace test {
+
+namespace {
+
+constexpr char c_lut_path[] = "lut_test.lut";
+
+bool rejected(const std::string& path)
+{
+  try
+  {
+    warp::CLutFile lut(path);
+  }
+  catch (const warp::LutError&)
+  {
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+void testLut(CChecker& checker)
+{
+  if (!checker.begin("lut"))
+  {
+    return;
+  }
+
+  warp::CUvMap uv_map({5u, 3u});
+  for (std::size_t i = 0; i < 15; ++i)
+  {
+    uv_map.us()[i] = (i == 7) ? -1.f : i / 14.f;
+    uv_map.vs()[i] = 1.f - i / 14.f;
+  }
+  warp::exportLut(uv_map, c_lut_path);
+
+  {
+    const warp::CUvMap loaded = warp::CLutFile(c_lut_path).toUvMap();
+    float diff = 0.f;
+    for (std::size_t i = 0; i < 15; ++i)
+    {
+      if (i != 7)
+      {
+        diff = std::max(diff, std::abs(loaded.us()[i] - uv_map.us()[i]));
+        diff = std::max(diff, std::abs(loaded.vs()[i] - uv_map.vs()[i]));
+      }
+    }
+    checker.expectNear(diff, 0., 1. / warp::c_lut_uv_scale, "round trip");
+    checker.expect(loaded.us()[7] < 0.f, "uncovered pixels stay uncovered");
+  }
+
+  // A smaller scale would decode coordinates far outside [0, 1]
+  {
+    std::fstream file(
+        c_lut_path, std::ios::in | std::ios::out | std::ios::binary);
+    const uint32_t uv_scale = 1;
+    file.seekp(offsetof(warp::LutHeader, uv_scale));
+    file.write(reinterpret_cast<const char*>(&uv_scale), sizeof(uv_scale));
+  }
+  checker.expect(rejected(c_lut_path), "foreign uv_scale is rejected");
+
+  std::remove(c_lut_path);
+}
+
+} // namespace test
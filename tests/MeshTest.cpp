@@ -0,0 +1,141 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <GLES2/gl2.h>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CFrameBuffer.hpp"
+#include "gles2/CMesh.hpp"
+#include "gles2/CShaderProgram.hpp"
+#include "gles2/CTexture2D.hpp"
+
+namespace test {
+
+namespace {
+
+constexpr char c_pos_vshader_src[] = R"(
+  attribute vec3 a_pos;
+
+  void main() {
+    gl_Position = vec4(a_pos, 1.0);
+  }
+)";
+
+constexpr char c_white_fshader_src[] = R"(
+  precision mediump float;
+
+  void main() {
+    gl_FragColor = vec4(1.0);
+  }
+)";
+
+constexpr char c_tex0_vshader_src[] = R"(
+  attribute vec2 a_tex0;
+  attribute vec3 a_pos;
+  varying vec2 v_tex0;
+
+  void main() {
+    v_tex0 = a_tex0;
+    gl_Position = vec4(a_pos, 1.0);
+  }
+)";
+
+constexpr char c_tex0_fshader_src[] = R"(
+  precision mediump float;
+  varying vec2 v_tex0;
+
+  void main() {
+    gl_FragColor = vec4(v_tex0, 0.0, 1.0);
+  }
+)";
+
+/// Red and green of the center pixel after drawing @p mesh.
+uint16_t drawCenter(gles2::CMesh& mesh, gles2::CShaderProgram& program)
+{
+  glClear(GL_COLOR_BUFFER_BIT);
+  gles2::CShaderProgram::use(program);
+  mesh.draw(program);
+  uint8_t pixel[4] = {};
+  glReadPixels(2, 2, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+  return static_cast<uint16_t>(pixel[0] << 8 | pixel[1]);
+}
+
+} // namespace
+
+void testMesh(CChecker& checker)
+{
+  if (!checker.begin("mesh"))
+  {
+    return;
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  {
+    gles2::CTexture2D target(glm::uvec2(4, 4), GL_RGBA);
+    gles2::CFrameBuffer frame_buffer(target);
+    gles2::CFrameBuffer::bind(frame_buffer);
+    glViewport(0, 0, 4, 4);
+    glClearColor(0.f, 0.f, 0.f, 1.f);
+
+    // A full screen quad, every vertex has the texture coordinate (1, 1)
+    gles2::CMesh mesh(
+        {{{-1.f, -1.f, 0.f}, {1.f, 1.f}},
+         {{1.f, -1.f, 0.f}, {1.f, 1.f}},
+         {{-1.f, 1.f, 0.f}, {1.f, 1.f}},
+         {{1.f, 1.f, 0.f}, {1.f, 1.f}}},
+        {0, 1, 2, 3});
+
+    // The mesh records the attributes of the first program, without a_tex0
+    std::optional<gles2::CShaderProgram> first;
+    first.emplace(c_pos_vshader_src, c_white_fshader_src);
+    const uint64_t first_serial = first->serial();
+    checker.expect(drawCenter(mesh, *first) == 0xffff, "first program draws");
+    first.reset();
+
+    // GL may give the next program the same name, bindings go by serial.
+    // Mesa doesn't reuse names right away, so the serials are checked too.
+    gles2::CShaderProgram second(c_tex0_vshader_src, c_tex0_fshader_src);
+    checker.expect(
+        second.serial() != first_serial && second.serial() != 0,
+        "programs get distinct serials");
+    checker.expect(
+        drawCenter(mesh, second) == 0xffff,
+        "second program gets its own attributes");
+
+    const uint64_t second_serial = second.serial();
+    gles2::CShaderProgram moved(std::move(second));
+    checker.expect(
+        moved.serial() == second_serial && second.serial() == 0,
+        "moves take the serial along");
+    gles2::CFrameBuffer::unbind();
+  }
+  egl::CContext::release(context);
+}
+
+} // namespace test
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <GLES2/gl2.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CShaderProgram.hpp"
+#include "gles2/ProgramCache.hpp"
+
+namespace test {
+
+namespace {
+
+constexpr char c_vshader_src[] = R"(
+  attribute vec4 a_pos;
+
+  void main() {
+    gl_Position = a_pos;
+  }
+)";
+
+constexpr char c_fshader_src[] = R"(
+  precision mediump float;
+
+  void main() {
+    gl_FragColor = vec4(1.0);
+  }
+)";
+
+bool loads(const std::string& key)
+{
+  GLuint program = glCreateProgram();
+  const bool loaded = gles2::loadProgramBinary(program, key);
+  glDeleteProgram(program);
+  return loaded;
+}
+
+// Magic, format and length, see ProgramCache.cpp
+constexpr std::uintmax_t c_header_size = 3 * sizeof(uint32_t);
+
+void writeLength(const std::filesystem::path& path, uint32_t length)
+{
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(2 * sizeof(uint32_t));
+  file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+}
+
+} // namespace
+
+void testProgramCache(CChecker& checker)
+{
+  if (!checker.begin("program_cache"))
+  {
+    return;
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  const std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "program_cache_test";
+  std::filesystem::remove_all(dir);
+  gles2::setProgramCacheDir(dir.string());
+  if (gles2::programCacheEnabled())
+  {
+    {
+      gles2::CShaderProgram program(c_vshader_src, c_fshader_src);
+    }
+    const std::string key =
+        gles2::programCacheKey(c_vshader_src, c_fshader_src);
+    const std::filesystem::path path = dir / (key + ".bin");
+    checker.expect(loads(key), "stored binary loads");
+    std::vector<std::filesystem::path> files;
+    for (auto&& entry : std::filesystem::directory_iterator(dir))
+    {
+      files.push_back(entry.path());
+    }
+    checker.expect(
+        files == std::vector<std::filesystem::path>{path},
+        "only the binary is left");
+
+    const auto size = std::filesystem::file_size(path);
+    writeLength(path, 0xffffffffu);
+    checker.expect(!loads(key), "oversized length is a miss");
+    writeLength(path, 0);
+    checker.expect(!loads(key), "empty length is a miss");
+    writeLength(path, static_cast<uint32_t>(size - c_header_size));
+    checker.expect(loads(key), "restored length loads");
+    std::filesystem::resize_file(path, size - 1);
+    checker.expect(!loads(key), "truncated binary is a miss");
+  }
+  gles2::setProgramCacheDir({});
+  std::filesystem::remove_all(dir);
+  egl::CContext::release(context);
+}
+
+} // namespace test
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Suites.hpp"
+#include "warp/Remap.hpp"
+
+namespace test {
+
+namespace {
+
+constexpr int c_width = 7;
+constexpr int c_height = 5;
+
+// Rows of more pixels than the widest implementation takes at once, plus a
+// tail the scalar loop finishes
+constexpr std::size_t c_count = 8 * 12 + 5;
+
+int maxDifference(
+    const std::vector<uint8_t>& lhs,
+    const std::vector<uint8_t>& rhs)
+{
+  int diff = 0;
+  for (std::size_t i = 0; i < lhs.size(); ++i)
+  {
+    diff = std::max(diff, std::abs(lhs[i] - rhs[i]));
+  }
+  return diff;
+}
+
+std::vector<uint8_t> remap(
+    warp::RemapRowFn fn,
+    const std::vector<float>& us,
+    const std::vector<float>& vs,
+    const std::vector<uint8_t>& src)
+{
+  std::vector<uint8_t> dst(4 * us.size());
+  fn(us.data(),
+     vs.data(),
+     us.size(),
+     src.data(),
+     c_width,
+     c_height,
+     dst.data());
+  return dst;
+}
+
+} // namespace
+
+void testRemap(CChecker& checker)
+{
+  if (!checker.begin("remap"))
+  {
+    return;
+  }
+
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint8_t> src(4 * c_width * c_height);
+  for (uint8_t& value : src)
+  {
+    value = static_cast<uint8_t>(byte(random));
+  }
+
+  // Inside, at the borders and far outside of [0, 1], GL_REPEAT applies
+  // to all of them. Negative and NaN u mark uncovered pixels.
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+  const float edges[] = {
+      0.f, 1.f, 1.0001f, -0.0001f, 1.5f, -1.5f, 3.75f, -7.2f, 1e3f, -1e6f,
+      3e9f, -3e9f, nan, inf, -inf};
+  std::uniform_real_distribution<float> inside(0.f, 1.f);
+  std::uniform_real_distribution<float> outside(-40.f, 40.f);
+  std::vector<float> us(c_count);
+  std::vector<float> vs(c_count);
+  for (std::size_t i = 0; i < c_count; ++i)
+  {
+    const bool edge = i % 3 == 0;
+    us[i] = edge ? edges[i / 3 % std::size(edges)]
+                 : (i % 3 == 1 ? inside(random) : outside(random));
+    vs[i] = edge ? edges[(i / 3 + 5) % std::size(edges)] : outside(random);
+  }
+
+  const std::vector<uint8_t> expected =
+      remap(warp::remapRowScalar, us, vs, src);
+
+  // Whole periods away only rounding of the coordinates differs
+  std::vector<float> us_shifted(c_count);
+  std::vector<float> vs_shifted(c_count);
+  std::vector<float> us_inside(c_count);
+  std::vector<float> vs_inside(c_count);
+  for (std::size_t i = 0; i < c_count; ++i)
+  {
+    us_inside[i] = inside(random);
+    vs_inside[i] = inside(random);
+    us_shifted[i] = us_inside[i] + 3.f;
+    vs_shifted[i] = vs_inside[i] - 2.f;
+  }
+
+  for (warp::RemapRowFn fn : warp::supportedRemapRows())
+  {
+    const std::string name = warp::remapRowName(fn);
+    checker.expect(
+        maxDifference(remap(fn, us, vs, src), expected) <= 1,
+        name + " matches the scalar remap outside [0, 1]");
+    checker.expect(
+        maxDifference(
+            remap(fn, us_shifted, vs_shifted, src),
+            remap(fn, us_inside, vs_inside, src)) <= 1,
+        name + " repeats the texture");
+
+    // Uncovered pixels are opaque black
+    const std::vector<float> uncovered = {-.5f, nan};
+    std::vector<uint8_t> black(8, 0);
+    black[3] = black[7] = 255;
+    checker.expect(
+        remap(fn, uncovered, {.5f, .5f}, src) == black,
+        name + " leaves uncovered pixels black");
+  }
+}
+
+} // namespace test
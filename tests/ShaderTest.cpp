@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <GLES2/gl2.h>
+#include <glm/vec4.hpp>
+#include <stdexcept>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CShaderProgram.hpp"
+
+namespace test {
+
+namespace {
+
+constexpr char c_vshader_src[] = R"(
+  attribute vec4 a_pos;
+  uniform float u_scale;
+
+  void main() {
+    gl_Position = a_pos * u_scale;
+  }
+)";
+
+constexpr char c_fshader_src[] = R"(
+  precision mediump float;
+  uniform vec4 u_col;
+
+  void main() {
+    gl_FragColor = u_col;
+  }
+)";
+
+} // namespace
+
+void testShader(CChecker& checker)
+{
+  if (!checker.begin("shader"))
+  {
+    return;
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  {
+    gles2::CShaderProgram program(c_vshader_src, c_fshader_src);
+    gles2::CShaderProgram::use(program);
+
+    bool thrown = false;
+    try
+    {
+      program.setUniform("u_scale", glm::vec4(1.f));
+      program.setUniform("u_missing", 1.f);
+    }
+    catch (const std::exception&)
+    {
+      thrown = true;
+    }
+    checker.expect(!thrown, "unknown names and other types are ignored");
+
+    program.setUniform("u_scale", 2.f);
+    GLfloat scale = 0.f;
+    glGetUniformfv(program.id(), program.uniformLocation("u_scale"), &scale);
+    checker.expectNear(scale, 2., 0., "u_scale after the ignored calls");
+
+    // Sent once, then shadowed
+    glUniform1f(program.uniformLocation("u_scale"), 3.f);
+    program.setUniform("u_scale", 2.f);
+    glGetUniformfv(program.id(), program.uniformLocation("u_scale"), &scale);
+    checker.expectNear(scale, 3., 0., "repeated value is not sent again");
+  }
+  egl::CContext::release(context);
+}
+
+} // namespace test
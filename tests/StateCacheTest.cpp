@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <GLES2/gl2.h>
+#include <glm/vec2.hpp>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CTexture2D.hpp"
+
+namespace test {
+
+namespace {
+
+GLint wrapOf(GLuint id)
+{
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, id);
+  GLint wrap = 0;
+  glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &wrap);
+  return wrap;
+}
+
+} // namespace
+
+void testStateCache(CChecker& checker)
+{
+  if (!checker.begin("state_cache"))
+  {
+    return;
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  {
+    gles2::CTexture2D first(glm::uvec2(4, 4), GL_RGBA);
+    gles2::CTexture2D second(glm::uvec2(4, 4), GL_RGBA);
+    first.setWrap(GL_CLAMP_TO_EDGE);
+    second.setWrap(GL_CLAMP_TO_EDGE);
+
+    // Leaves unit 1 active while the first texture stays on unit 0
+    gles2::CTexture2D::bind(first, 0);
+    gles2::CTexture2D::bind(second, 1);
+    first.setWrap(GL_REPEAT);
+
+    checker.expect(
+        wrapOf(first.id()) == GL_REPEAT, "edit reaches the bound texture");
+    checker.expect(
+        wrapOf(second.id()) == GL_CLAMP_TO_EDGE,
+        "edit leaves the active unit's texture");
+  }
+  egl::CContext::release(context);
+}
+
+} // namespace test
@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <GLES2/gl2.h>
+#include <algorithm>
+#include <cstdint>
+#include <glm/common.hpp>
+#include <string>
+#include <vector>
+
+#include "Suites.hpp"
+#include "egl/CContext.hpp"
+#include "gles2/CFrameBuffer.hpp"
+#include "gles2/CMesh.hpp"
+#include "gles2/CShaderProgram.hpp"
+#include "gles2/CTexture2D.hpp"
+#include "warp/CSplineSurface.hpp"
+#include "warp/DistortionMesh.hpp"
+#include "warp/SurfaceShader.hpp"
+
+namespace test {
+
+namespace {
+
+/// Pixels per row of the position readback.
+constexpr std::size_t c_check_width = 256;
+/// The 16 bit readback resolves 6e-5, the rest is float rounding.
+constexpr double c_tolerance = 1e-4;
+
+// Every vertex becomes the point on the pixel of its index, which holds
+// the evaluated position as 16 bits per axis over [-2, 2]
+constexpr char c_check_vshader_src[] = R"(
+  attribute vec3 a_pos;
+  attribute vec2 a_tex0;
+  varying vec2 v_pos;
+
+  void main() {
+    v_pos = evaluateSurface(a_tex0);
+    gl_PointSize = 1.0;
+    gl_Position = vec4(a_pos, 1.0);
+  }
+)";
+
+constexpr char c_check_fshader_src[] = R"(
+  precision highp float;
+  varying vec2 v_pos;
+
+  vec2 encode(float value) {
+    float n = floor(clamp((value + 2.0) / 4.0, 0.0, 1.0) * 65535.0 + 0.5);
+    float high = floor(n / 256.0);
+    return vec2(high, n - high * 256.0) / 255.0;
+  }
+
+  void main() {
+    gl_FragColor = vec4(encode(v_pos.x), encode(v_pos.y));
+  }
+)";
+
+float decode(const uint8_t* bytes)
+{
+  return (bytes[0] * 256 + bytes[1]) / 65535.f * 4.f - 2.f;
+}
+
+warp::KeyPoints makeCurvedKeyPoints(const glm::uvec2& size)
+{
+  warp::KeyPoints kps = warp::makeDefaultKeyPoints(size);
+  for (glm::vec2& p : kps.points)
+  {
+    p = glm::vec2(p.x * (1.f - .08f * p.y * p.y), p.y * (.9f + .05f * p.x));
+  }
+  return kps;
+}
+
+/// Positions the surface shader evaluates at the parameters of @p reference.
+std::vector<glm::vec2> evaluateOnGpu(
+    gles2::CShaderProgram& program,
+    const warp::KeyPoints& kps,
+    const gles2::CMesh::Vertices& reference)
+{
+  const glm::uvec2 size(
+      c_check_width, (reference.size() + c_check_width - 1) / c_check_width);
+  gles2::CMesh::Vertices vertices;
+  gles2::CMesh::Indices indices;
+  for (std::size_t i = 0; i < reference.size(); ++i)
+  {
+    const glm::vec2 pixel(i % size.x + .5f, i / size.x + .5f);
+    vertices.push_back(
+        {glm::vec3(pixel / glm::vec2(size) * 2.f - 1.f, 0.f),
+         reference[i].text0});
+    indices.push_back(static_cast<uint32_t>(i));
+  }
+  gles2::CMesh mesh(std::move(vertices), std::move(indices));
+
+  gles2::CTexture2D target(size, GL_RGBA, nullptr, GL_NEAREST);
+  gles2::CFrameBuffer frame_buffer(target);
+  gles2::CFrameBuffer::bind(frame_buffer);
+  glViewport(0, 0, size.x, size.y);
+  glClearColor(0.f, 0.f, 0.f, 0.f);
+  glClear(GL_COLOR_BUFFER_BIT);
+  gles2::CShaderProgram::use(program);
+  warp::setSurfaceUniforms(program, warp::CSplineSurface(kps));
+  mesh.draw(program, true);
+
+  std::vector<uint8_t> pixels(size.x * size.y * 4);
+  glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  gles2::CFrameBuffer::unbind();
+
+  std::vector<glm::vec2> positions;
+  for (std::size_t i = 0; i < reference.size(); ++i)
+  {
+    const uint8_t* pixel = &pixels[i * 4];
+    positions.emplace_back(decode(pixel), decode(pixel + 2));
+  }
+  return positions;
+}
+
+void checkGrid(
+    CChecker& checker,
+    gles2::CShaderProgram& program,
+    const warp::KeyPoints& kps,
+    std::size_t count)
+{
+  const std::string what = std::to_string(kps.size.x) + "x" +
+                           std::to_string(kps.size.y) + " grid, " +
+                           std::to_string(count) + " vertices across";
+  const gles2::CMesh::Vertices reference =
+      warp::generateDistortionVertices(count, kps);
+  const std::vector<glm::vec2> positions =
+      evaluateOnGpu(program, kps, reference);
+
+  // Reports the farthest vertex only, not thousands of them
+  float max_diff = -1.f;
+  std::size_t worst = 0;
+  for (std::size_t i = 0; i < reference.size(); ++i)
+  {
+    const glm::vec3& position = reference[i].position;
+    const glm::vec2 diff =
+        glm::abs(positions[i] - glm::vec2(position.x, position.y));
+    if (std::max(diff.x, diff.y) > max_diff)
+    {
+      max_diff = std::max(diff.x, diff.y);
+      worst = i;
+    }
+  }
+  const std::string at = what + ", vertex " + std::to_string(worst);
+  checker.expectNear(
+      positions[worst].x, reference[worst].position.x, c_tolerance, at + " x");
+  checker.expectNear(
+      positions[worst].y, reference[worst].position.y, c_tolerance, at + " y");
+}
+
+} // namespace
+
+void testSurface(CChecker& checker)
+{
+  if (!checker.begin("surface"))
+  {
+    return;
+  }
+
+  egl::CContext context;
+  egl::CContext::makeCurrent(context);
+  {
+    gles2::CShaderProgram program(
+        warp::surfaceVertexShader(c_check_vshader_src), c_check_fshader_src);
+
+    warp::KeyPoints curved = makeCurvedKeyPoints({4u, 4u});
+    checkGrid(checker, program, curved, 30);
+    checkGrid(checker, program, curved, 120);
+
+    // Moving a point has to reach the shader through the uniforms alone
+    curved.points[5] += glm::vec2(.05f, -.03f);
+    checkGrid(checker, program, curved, 30);
+
+    // Non-square grids index the control net by rows of u_patches.x
+    checkGrid(checker, program, makeCurvedKeyPoints({6u, 3u}), 30);
+  }
+  egl::CContext::release(context);
+}
+
+} // namespace test
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <algorithm>
+#include <glm/geometric.hpp>
+#include <string>
+
+#include "Suites.hpp"
+#include "warp/CSplineSurface.hpp"
+#include "warp/KeyPoints.hpp"
+#include "warp/Tessellation.hpp"
+
+namespace test {
+
+namespace {
+
+/// Samples per cell side of the reference, far more than the tessellation
+/// takes.
+constexpr int c_reference_steps = 64;
+
+/// Distance between the triangles of @p tessellation and the surface in
+/// pixels, evaluated densely. Cells split like generateGridIndices() does.
+float referenceError(
+    const warp::CSplineSurface& surface,
+    const warp::Tessellation& tessellation,
+    const glm::vec2& scale)
+{
+  const auto& us = tessellation.us;
+  const auto& vs = tessellation.vs;
+  float error = 0.f;
+  for (std::size_t i = 0; i + 1 < us.size(); ++i)
+  {
+    for (std::size_t j = 0; j + 1 < vs.size(); ++j)
+    {
+      const glm::vec2 p00 = surface.evaluate({us[i], vs[j]});
+      const glm::vec2 p10 = surface.evaluate({us[i + 1], vs[j]});
+      const glm::vec2 p01 = surface.evaluate({us[i], vs[j + 1]});
+      const glm::vec2 p11 = surface.evaluate({us[i + 1], vs[j + 1]});
+      for (int k = 0; k <= c_reference_steps; ++k)
+      {
+        for (int l = 0; l <= c_reference_steps; ++l)
+        {
+          const float s = static_cast<float>(k) / c_reference_steps;
+          const float t = static_cast<float>(l) / c_reference_steps;
+          const glm::vec2 linear =
+              (s + t <= 1.f)
+                  ? p00 + (p10 - p00) * s + (p01 - p00) * t
+                  : p11 + (p01 - p11) * (1.f - s) + (p10 - p11) * (1.f - t);
+          const glm::vec2 exact = surface.evaluate(
+              {us[i] + (us[i + 1] - us[i]) * s,
+               vs[j] + (vs[j + 1] - vs[j]) * t});
+          error = std::max(error, glm::length((exact - linear) * scale));
+        }
+      }
+    }
+  }
+  return error;
+}
+
+/// A 4x4 grid with one corner patch pulled far out of shape.
+warp::KeyPoints makeBentKeyPoints()
+{
+  warp::KeyPoints kps = warp::makeDefaultKeyPoints({4u, 4u});
+  for (glm::vec2& p : kps.points)
+  {
+    p = glm::vec2(p.x * (1.f - .08f * p.y * p.y), p.y * (.9f + .05f * p.x));
+  }
+  kps.points[5] += glm::vec2(.15f, -.1f);
+  return kps;
+}
+
+} // namespace
+
+void testTessellation(CChecker& checker)
+{
+  if (!checker.begin("tessellation"))
+  {
+    return;
+  }
+
+  const warp::CSplineSurface surface(makeBentKeyPoints());
+  const glm::uvec2 viewport(1280u, 720u);
+  const glm::vec2 scale = glm::vec2(viewport) * 0.5f;
+  for (float tolerance : {16.f, 8.f, 2.f, .5f, .1f})
+  {
+    const std::string what = std::to_string(tolerance) + " px";
+    const warp::Tessellation tessellation =
+        warp::tessellateSurface(surface, viewport, tolerance);
+    const float reference = referenceError(surface, tessellation, scale);
+    checker.expect(
+        reference <= tolerance, what + ", dense error " +
+                                    std::to_string(reference) +
+                                    " within the tolerance");
+    // The reported bound may only miss the dense maximum by a hair
+    checker.expect(
+        reference <= tessellation.max_error * 1.005f,
+        what + ", reported error " + std::to_string(tessellation.max_error) +
+            " covers the dense one");
+  }
+}
+
+} // namespace test
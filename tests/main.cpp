@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "CChecker.hpp"
+#include "Suites.hpp"
+
+int main(int argc, const char** argv)
+{
+  // [filter], runs the suites whose name contains it
+  test::CChecker checker(argc > 1 ? argv[1] : "");
+
+  test::testBlend(checker);
+  test::testFileWatcher(checker);
+  test::testImageCache(checker);
+  test::testLut(checker);
+  test::testMesh(checker);
+  test::testProgramCache(checker);
+  test::testRemap(checker);
+  test::testShader(checker);
+  test::testStateCache(checker);
+  test::testSurface(checker);
+  test::testTessellation(checker);
+
+  std::cout << checker.checks() << " checks, " << checker.failures()
+            << " failed" << std::endl;
+  return checker.failures() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
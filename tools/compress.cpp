@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Yuriy Khokhulya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "gles2/CTexture2D.hpp"
+#include "gles2/Etc.hpp"
+#include "gles2/Ktx.hpp"
+
+namespace {
+
+struct Options
+{
+  bool etc2 = false;
+  bool mipmaps = false;
+  std::filesystem::path output_dir;
+  std::vector<std::string> image_paths;
+};
+
+void printUsage(std::ostream& os, const char* argv0)
+{
+  os << "Usage: " << argv0 << " [options] <output-dir> <image...>\n"
+     << "Compresses images to <output-dir>/<name>.ktx for the GLES2 "
+        "renderer.\n"
+     << "  --etc2     ETC2, keeps alpha (default: ETC1, which every GLES2 "
+        "driver\n"
+     << "             with OES_compressed_ETC1_RGB8_texture takes)\n"
+     << "  --mipmaps  store the mip chain, NPOT images are rescaled to "
+        "power of two\n";
+}
+
+// Compresses one image, returns false when it failed
+bool compress(
+    const Options& opts,
+    const std::string& path,
+    std::mutex& log_mutex)
+{
+  try
+  {
+    const gles2::CTexture2D::Decoded image =
+        gles2::CTexture2D::decode(path, opts.mipmaps);
+    const GLenum format = !opts.etc2                ? gles2::c_etc1_rgb8
+                          : (GL_RGBA == image.format) ? gles2::c_etc2_rgba8_eac
+                                                      : gles2::c_etc2_rgb8;
+    const gles2::CTexture2D::Decoded compressed =
+        gles2::compressEtc(image, format, opts.mipmaps);
+    const auto output =
+        opts.output_dir / std::filesystem::path(path).stem().concat(".ktx");
+    gles2::writeKtx(output.string(), compressed);
+
+    std::lock_guard lock(log_mutex);
+    if (GL_RGBA == image.format && !opts.etc2)
+    {
+      std::cerr << path << ": ETC1 drops the alpha channel" << std::endl;
+    }
+    std::cout << path << " -> " << output.string() << " ("
+              << image.pixels.size() / 1024 << " KiB -> "
+              << compressed.pixels.size() / 1024 << " KiB)" << std::endl;
+    return true;
+  }
+  catch (const std::runtime_error& e)
+  {
+    std::lock_guard lock(log_mutex);
+    std::cerr << "Failed to compress " << path << ": " << e.what()
+              << std::endl;
+    return false;
+  }
+}
+
+} // namespace
+
+int main(int argc, const char** argv)
+{
+  Options opts;
+  std::vector<std::string_view> positional;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string_view arg(argv[i]);
+    if (arg == "--etc2")
+    {
+      opts.etc2 = true;
+    }
+    else if (arg == "--mipmaps")
+    {
+      opts.mipmaps = true;
+    }
+    else if (arg == "--help" || arg == "-h")
+    {
+      printUsage(std::cout, argv[0]);
+      return EXIT_SUCCESS;
+    }
+    else if (!arg.empty() && arg[0] == '-')
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      printUsage(std::cerr, argv[0]);
+      return EXIT_FAILURE;
+    }
+    else
+    {
+      positional.push_back(arg);
+    }
+  }
+  if (positional.size() < 2)
+  {
+    printUsage(std::cerr, argv[0]);
+    return EXIT_FAILURE;
+  }
+  opts.output_dir = positional.front();
+  opts.image_paths.assign(positional.begin() + 1, positional.end());
+
+  std::error_code error;
+  std::filesystem::create_directories(opts.output_dir, error);
+  if (error)
+  {
+    std::cerr << "Couldn't create " << opts.output_dir.string() << ": "
+              << error.message() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Compression is slow enough to give each image a core
+  std::atomic<std::size_t> next(0);
+  std::atomic<std::size_t> num_failed(0);
+  std::mutex log_mutex;
+  std::vector<std::thread> workers;
+  const std::size_t num_threads = std::clamp<std::size_t>(
+      std::thread::hardware_concurrency(), 1, opts.image_paths.size());
+  for (std::size_t t = 0; t < num_threads; ++t)
+  {
+    workers.emplace_back([&] {
+      for (std::size_t i = next++; i < opts.image_paths.size(); i = next++)
+      {
+        if (!compress(opts, opts.image_paths[i], log_mutex))
+        {
+          ++num_failed;
+        }
+      }
+    });
+  }
+  for (auto&& worker : workers)
+  {
+    worker.join();
+  }
+
+  return (0 == num_failed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}